@@ -17,7 +17,9 @@ public class FabulousDualSense : ModuleRules
 
 		PrivateDependencyModuleNames.AddRange(new[]
 		{
-			"ApplicationCore", "InputCore", "InputDevice", "SlateCore", "Slate", "DualSenseWindows"
+			"ApplicationCore", "InputCore", "InputDevice", "Json", "RenderCore", "SlateCore", "Slate", "DualSenseWindows"
 		});
+
+		PublicSystemLibraries.Add("setupapi.lib");
 	}
 }
\ No newline at end of file
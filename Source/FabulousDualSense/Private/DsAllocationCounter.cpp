@@ -0,0 +1,155 @@
+#include "DsAllocationCounter.h"
+
+#include <atomic>
+
+#include "HAL/MemoryBase.h"
+
+namespace DsAllocationCounter
+{
+	class FCountingMalloc final : public FMalloc
+	{
+	private:
+		FMalloc* InnerMalloc{nullptr};
+
+		std::atomic<uint32> CountedThreadId{0};
+
+		std::atomic<int64> AllocationsCount{0};
+
+	public:
+		void Install()
+		{
+			check(GMalloc != this);
+
+			InnerMalloc = GMalloc;
+
+			AllocationsCount.store(0, std::memory_order_relaxed);
+			CountedThreadId.store(FPlatformTLS::GetCurrentThreadId(), std::memory_order_release);
+
+			GMalloc = this;
+		}
+
+		void Uninstall()
+		{
+			check(GMalloc == this);
+
+			GMalloc = InnerMalloc;
+
+			// The inner allocator is intentionally kept, since other threads may still be inside this proxy.
+
+			CountedThreadId.store(0, std::memory_order_release);
+		}
+
+		int64 GetAllocationsCount() const
+		{
+			return AllocationsCount.load(std::memory_order_relaxed);
+		}
+
+		virtual void* Malloc(const SIZE_T Count, const uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(const SIZE_T Count, const uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, const SIZE_T Count, const uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, const SIZE_T Count, const uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+
+			return InnerMalloc->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			InnerMalloc->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(const SIZE_T Count, const uint32 Alignment) override
+		{
+			return InnerMalloc->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return InnerMalloc->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(const bool bTrimThreadCaches) override
+		{
+			InnerMalloc->Trim(bTrimThreadCaches);
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return InnerMalloc->IsInternallyThreadSafe();
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return InnerMalloc->ValidateHeap();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return InnerMalloc->GetDescriptiveName();
+		}
+
+	private:
+		void CountAllocation()
+		{
+			if (CountedThreadId.load(std::memory_order_acquire) == FPlatformTLS::GetCurrentThreadId())
+			{
+				AllocationsCount.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	// Never destroyed, because other threads may have read GMalloc while the proxy was installed.
+	FCountingMalloc& GetCountingMalloc()
+	{
+		static auto* CountingMalloc{new FCountingMalloc};
+		return *CountingMalloc;
+	}
+}
+
+FDsAllocationCounter::FDsAllocationCounter()
+{
+	DsAllocationCounter::GetCountingMalloc().Install();
+}
+
+FDsAllocationCounter::~FDsAllocationCounter()
+{
+	DsAllocationCounter::GetCountingMalloc().Uninstall();
+}
+
+int64 FDsAllocationCounter::GetAllocationsCount() const
+{
+	return DsAllocationCounter::GetCountingMalloc().GetAllocationsCount();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+// Counts heap allocations made on the current thread while it is alive, by temporarily replacing
+// GMalloc with a proxy. Allocations made on other threads pass through the proxy without being counted.
+class FABULOUSDUALSENSE_API FDsAllocationCounter
+{
+public:
+	FDsAllocationCounter();
+
+	~FDsAllocationCounter();
+
+	int64 GetAllocationsCount() const;
+
+	FDsAllocationCounter(const FDsAllocationCounter&) = delete;
+
+	FDsAllocationCounter& operator=(const FDsAllocationCounter&) = delete;
+};
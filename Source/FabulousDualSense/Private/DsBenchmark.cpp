@@ -0,0 +1,122 @@
+#include "DsBenchmark.h"
+
+#include <DualSenseWindows.h>
+
+#include "DsImuCalibration.h"
+#include "DsReport.h"
+#include "Math/RandomStream.h"
+#include "Misc/OutputDevice.h"
+
+void DsBenchmark::RunCrc(FOutputDevice& Archive)
+{
+	static constexpr auto ReportsCount{1000000};
+
+	uint8 Report[DS_INPUT_REPORT_BT_SIZE];
+
+	const FRandomStream RandomStream{0xD5};
+
+	for (auto& Byte : Report)
+	{
+		Byte = static_cast<uint8>(RandomStream.RandHelper(256));
+	}
+
+	Report[0] = DS_INPUT_REPORT_BT;
+
+	DsReport::StampBluetoothReport(DsReport::InputReportCrcSeed, Report, DS_INPUT_REPORT_BT_SIZE);
+
+	auto ValidReportsCount{0};
+
+	const auto StartCycles{FPlatformTime::Cycles64()};
+
+	for (auto i{0}; i < ReportsCount; i++)
+	{
+		// Change the report every iteration so that the validation can't be hoisted out of the loop.
+
+		Report[2] = static_cast<uint8>(i);
+
+		ValidReportsCount += DsReport::IsBluetoothReportValid(DsReport::InputReportCrcSeed, Report, DS_INPUT_REPORT_BT_SIZE) ? 1 : 0;
+	}
+
+	const auto Seconds{FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles)};
+
+	Archive.Logf(TEXT("CRC32: %d reports of %d bytes in %.3f ms, %.1f ns per report, %.1f MB/s (%d valid)."),
+	             ReportsCount, DS_INPUT_REPORT_BT_SIZE, Seconds * 1000.0, Seconds * 1000000000.0 / ReportsCount,
+	             ReportsCount * DS_INPUT_REPORT_BT_SIZE / Seconds / (1024.0 * 1024.0), ValidReportsCount);
+}
+
+void DsBenchmark::RunImuCalibration(FOutputDevice& Archive)
+{
+	static constexpr auto ReportsCount{1000000};
+
+	const FRandomStream RandomStream{0xD5};
+
+	// Values similar to those reported by real devices.
+
+	DS5W::DeviceCalibrationData CalibrationData{};
+
+	for (auto& Axis : CalibrationData.gyroscope)
+	{
+		Axis.bias = static_cast<short>(RandomStream.RandRange(-64, 64));
+		Axis.sens_numer = RandomStream.RandRange(1900, 2100) * DS_GYRO_RES_PER_DEG_S;
+		Axis.sens_denom = RandomStream.RandRange(30000, 36000);
+	}
+
+	for (auto& Axis : CalibrationData.accelerometer)
+	{
+		Axis.bias = static_cast<short>(RandomStream.RandRange(-256, 256));
+		Axis.sens_numer = 2 * DS_ACC_RES_PER_G;
+		Axis.sens_denom = RandomStream.RandRange(15000, 18000);
+	}
+
+	FDsImuCalibration ImuCalibration;
+	ImuCalibration.Compile(CalibrationData);
+
+	int16 RawValues[FDsImuCalibration::AxesCount];
+
+	for (auto& Value : RawValues)
+	{
+		Value = static_cast<int16>(RandomStream.RandRange(TNumericLimits<int16>::Min(), TNumericLimits<int16>::Max()));
+	}
+
+	int64 Checksum{0};
+
+	auto StartCycles{FPlatformTime::Cycles64()};
+
+	for (auto i{0}; i < ReportsCount; i++)
+	{
+		// Change the values every iteration so that the calibration can't be hoisted out of the loop.
+
+		RawValues[i % FDsImuCalibration::AxesCount] += 1;
+
+		for (auto j{0}; j < 3; j++)
+		{
+			Checksum += CalibrationData.gyroscope[j].calibrate(RawValues[j]);
+			Checksum += CalibrationData.accelerometer[j].calibrate(RawValues[j + 3]);
+		}
+	}
+
+	const auto ReferenceSeconds{FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles)};
+
+	StartCycles = FPlatformTime::Cycles64();
+
+	for (auto i{0}; i < ReportsCount; i++)
+	{
+		RawValues[i % FDsImuCalibration::AxesCount] += 1;
+
+		int32 CalibratedValues[FDsImuCalibration::AxesCount];
+		float PhysicalValues[FDsImuCalibration::AxesCount];
+
+		ImuCalibration.Calibrate(RawValues, CalibratedValues, PhysicalValues);
+
+		for (auto j{0}; j < FDsImuCalibration::AxesCount; j++)
+		{
+			Checksum += CalibratedValues[j];
+		}
+	}
+
+	const auto Seconds{FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles)};
+
+	Archive.Logf(TEXT("IMU calibration: %d reports, reference: %.1f ns per report, precompiled: %.1f ns per report, %.2fx (checksum %lld)."),
+	             ReportsCount, ReferenceSeconds * 1000000000.0 / ReportsCount, Seconds * 1000000000.0 / ReportsCount,
+	             Seconds > 0.0 ? ReferenceSeconds / Seconds : 0.0, Checksum);
+}
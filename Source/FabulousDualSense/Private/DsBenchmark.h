@@ -0,0 +1,12 @@
+#pragma once
+
+class FOutputDevice;
+
+namespace DsBenchmark
+{
+	void RunCrc(FOutputDevice& Archive);
+
+	// Compares the precompiled calibration with the reference implementation. Their bit-exactness
+	// is verified by the FabulousDualSense.ImuCalibration.BitExactness automation test.
+	void RunImuCalibration(FOutputDevice& Archive);
+}
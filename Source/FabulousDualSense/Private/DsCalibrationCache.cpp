@@ -0,0 +1,404 @@
+#include "DsCalibrationCache.h"
+
+#include "DsReport.h"
+#include "DsUtility.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Tasks/Task.h"
+
+#include "Windows/AllowWindowsPlatformTypes.h"
+
+#include <hidsdi.h>
+
+#include "Windows/HideWindowsPlatformTypes.h"
+
+namespace DsCalibrationCache
+{
+	static constexpr uint32 FileMagic{0x43435344}; // "DSCC".
+
+	// Must be incremented whenever the layout of the cache entries, including FDsImuCalibration, changes.
+	static constexpr uint32 FileVersion{2};
+
+	// Limits how often the cache is written while gyroscope biases and firmware infos keep changing.
+	static constexpr auto SaveInterval{10.0};
+
+	static constexpr auto FirmwareInfoHardwareVersionOffset{24};
+	static constexpr auto FirmwareInfoFirmwareVersionOffset{28};
+
+	bool IsCalibrationValid(const DS5W::DeviceCalibrationData& CalibrationData)
+	{
+		for (const auto& Axis : CalibrationData.gyroscope)
+		{
+			if (Axis.sens_denom == 0)
+			{
+				return false;
+			}
+		}
+
+		for (const auto& Axis : CalibrationData.accelerometer)
+		{
+			if (Axis.sens_denom == 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool AreAxesEqual(const DS5W::AxisCalibrationData& A, const DS5W::AxisCalibrationData& B)
+	{
+		// Compared field by field, since the structure has padding.
+
+		return A.bias == B.bias && A.sens_numer == B.sens_numer && A.sens_denom == B.sens_denom;
+	}
+
+	bool AreCalibrationsEqual(const DS5W::DeviceCalibrationData& A, const DS5W::DeviceCalibrationData& B)
+	{
+		for (auto i{0}; i < 3; i++)
+		{
+			if (!AreAxesEqual(A.gyroscope[i], B.gyroscope[i]) || !AreAxesEqual(A.accelerometer[i], B.accelerometer[i]))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void SerializeAxis(FArchive& Archive, DS5W::AxisCalibrationData& Axis)
+	{
+		int16 Bias{Axis.bias};
+		int32 Numerator{Axis.sens_numer};
+		int32 Denominator{Axis.sens_denom};
+
+		Archive << Bias << Numerator << Denominator;
+
+		Axis.bias = Bias;
+		Axis.sens_numer = Numerator;
+		Axis.sens_denom = Denominator;
+	}
+
+	void SerializeEntry(FArchive& Archive, uint32& DeviceId, FDsCalibrationCacheEntry& Entry)
+	{
+		Archive << DeviceId;
+
+		for (auto& Axis : Entry.CalibrationData.gyroscope)
+		{
+			SerializeAxis(Archive, Axis);
+		}
+
+		for (auto& Axis : Entry.CalibrationData.accelerometer)
+		{
+			SerializeAxis(Archive, Axis);
+		}
+
+		// The cache is local to the machine, so the precompiled coefficients are stored as is.
+
+		Archive.Serialize(&Entry.ImuCalibration, sizeof(FDsImuCalibration));
+
+		Archive << Entry.HardwareVersion << Entry.FirmwareVersion;
+
+		Archive << Entry.GyroBias << Entry.bHasGyroBias;
+	}
+
+	bool ReadFirmwareInfo(const TCHAR* DevicePath, uint32& HardwareVersion, uint32& FirmwareVersion)
+	{
+		const auto DeviceHandle{
+			CreateFileW(DevicePath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr)
+		};
+
+		if (DeviceHandle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		ON_SCOPE_EXIT
+		{
+			CloseHandle(DeviceHandle);
+		};
+
+		uint8 Report[DS_FEATURE_REPORT_FIRMWARE_INFO_SIZE]{DS_FEATURE_REPORT_FIRMWARE_INFO};
+
+		if (!HidD_GetFeature(DeviceHandle, Report, sizeof(Report)))
+		{
+			return false;
+		}
+
+		HardwareVersion = DsReport::ReadUInt32(Report + FirmwareInfoHardwareVersionOffset);
+		FirmwareVersion = DsReport::ReadUInt32(Report + FirmwareInfoFirmwareVersionOffset);
+		return true;
+	}
+}
+
+FDsCalibrationCache::FDsCalibrationCache()
+{
+	Load();
+}
+
+FDsCalibrationCache::~FDsCalibrationCache()
+{
+	// The firmware info requests are not waited for, since they may be stuck on a hung device. They only use
+	// the shared queue and their own copy of the device path, so they can safely outlive the cache.
+
+	ApplyFirmwareInfo();
+
+	// The last changes are saved right away, regardless of the save interval, since there will be no further updates.
+
+	if (bDirty)
+	{
+		Save(true);
+	}
+}
+
+void FDsCalibrationCache::ResolveCalibration(const uint32 DeviceId, const TCHAR* DevicePath,
+                                             DS5W::DeviceCalibrationData& CalibrationData, FDsImuCalibration& ImuCalibration)
+{
+	RequestFirmwareInfo(DeviceId, DevicePath);
+
+	auto* Entry{Entries.Find(DeviceId)};
+
+	if (!DsCalibrationCache::IsCalibrationValid(CalibrationData))
+	{
+		if (Entry != nullptr)
+		{
+			UE_LOG(LogFabulousDualSense, Warning, TEXT("Invalid device calibration data, using the cached one instead: %s."), DevicePath);
+
+			CalibrationData = Entry->CalibrationData;
+			ImuCalibration = Entry->ImuCalibration;
+		}
+		else
+		{
+			UE_LOG(LogFabulousDualSense, Warning, TEXT("Invalid device calibration data: %s."), DevicePath);
+
+			// Not cached, so that the next connection gets another chance to read valid calibration data.
+
+			ImuCalibration.Compile(CalibrationData);
+		}
+
+		return;
+	}
+
+	if (Entry != nullptr && DsCalibrationCache::AreCalibrationsEqual(Entry->CalibrationData, CalibrationData))
+	{
+		ImuCalibration = Entry->ImuCalibration;
+		return;
+	}
+
+	if (Entry != nullptr)
+	{
+		UE_LOG(LogFabulousDualSense, Log, TEXT("Device calibration data changed: %s."), DevicePath);
+
+		// The bias was estimated on top of the old calibration data.
+
+		Entry->GyroBias = FVector3f::ZeroVector;
+		Entry->bHasGyroBias = false;
+	}
+	else
+	{
+		Entry = &Entries.Add(DeviceId);
+	}
+
+	Entry->CalibrationData = CalibrationData;
+	Entry->ImuCalibration.Compile(CalibrationData);
+
+	ImuCalibration = Entry->ImuCalibration;
+
+	bDirty = true;
+}
+
+bool FDsCalibrationCache::GetGyroBias(const uint32 DeviceId, FVector3f& GyroBias) const
+{
+	const auto* Entry{Entries.Find(DeviceId)};
+	if (Entry == nullptr || !Entry->bHasGyroBias)
+	{
+		return false;
+	}
+
+	GyroBias = Entry->GyroBias;
+	return true;
+}
+
+void FDsCalibrationCache::SetGyroBias(const uint32 DeviceId, const FVector3f& GyroBias)
+{
+	// The entry may be missing if the device returned invalid calibration data. Tiny
+	// changes are ignored, so that the cache isn't saved every time the estimate wobbles.
+
+	static constexpr auto Tolerance{0.001f};
+
+	auto* Entry{Entries.Find(DeviceId)};
+	if (Entry == nullptr || (Entry->bHasGyroBias && Entry->GyroBias.Equals(GyroBias, Tolerance)))
+	{
+		return;
+	}
+
+	Entry->GyroBias = GyroBias;
+	Entry->bHasGyroBias = true;
+
+	bDirty = true;
+}
+
+void FDsCalibrationCache::Update()
+{
+	ApplyFirmwareInfo();
+
+	if (bDirty && FPlatformTime::Seconds() >= NextSaveTime)
+	{
+		Save(false);
+	}
+}
+
+void FDsCalibrationCache::ApplyFirmwareInfo()
+{
+	FFirmwareInfo FirmwareInfo;
+
+	while (FirmwareInfoQueue->Dequeue(FirmwareInfo))
+	{
+		// The entry may be missing if the device returned invalid calibration data.
+
+		auto* Entry{Entries.Find(FirmwareInfo.DeviceId)};
+		if (Entry == nullptr ||
+		    (Entry->HardwareVersion == FirmwareInfo.HardwareVersion && Entry->FirmwareVersion == FirmwareInfo.FirmwareVersion))
+		{
+			continue;
+		}
+
+		UE_LOG(LogFabulousDualSense, Log, TEXT("Device firmware info updated: Hardware: 0x%08X, Firmware: 0x%08X, Device ID: 0x%08X."),
+		       FirmwareInfo.HardwareVersion, FirmwareInfo.FirmwareVersion, FirmwareInfo.DeviceId);
+
+		Entry->HardwareVersion = FirmwareInfo.HardwareVersion;
+		Entry->FirmwareVersion = FirmwareInfo.FirmwareVersion;
+
+		bDirty = true;
+	}
+}
+
+void FDsCalibrationCache::RequestFirmwareInfo(const uint32 DeviceId, const TCHAR* DevicePath)
+{
+	// The firmware info isn't needed to deliver input, so it's read on a separate
+	// device handle in the background to avoid delaying the device connection.
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [DeviceId, DevicePath{FString{DevicePath}}, Queue{FirmwareInfoQueue}]
+	{
+		FFirmwareInfo FirmwareInfo{.DeviceId = DeviceId};
+
+		if (DsCalibrationCache::ReadFirmwareInfo(*DevicePath, FirmwareInfo.HardwareVersion, FirmwareInfo.FirmwareVersion))
+		{
+			Queue->Enqueue(FirmwareInfo);
+		}
+	}, LowLevelTasks::ETaskPriority::BackgroundNormal);
+}
+
+void FDsCalibrationCache::Load()
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *GetFilePath(), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader{Data};
+
+	uint32 Magic{0};
+	uint32 Version{0};
+	uint32 Crc{0};
+	int32 EntriesCount{0};
+
+	Reader << Magic << Version << Crc;
+
+	if (Reader.IsError() || Magic != DsCalibrationCache::FileMagic || Version != DsCalibrationCache::FileVersion ||
+	    Crc != FCrc::MemCrc32(Data.GetData() + Reader.Tell(), static_cast<int32>(Data.Num() - Reader.Tell())))
+	{
+		UE_LOG(LogFabulousDualSense, Log, TEXT("Calibration cache is outdated or corrupted and will be rebuilt."));
+		return;
+	}
+
+	Reader << EntriesCount;
+
+	for (auto i{0}; i < EntriesCount && !Reader.IsError(); i++)
+	{
+		uint32 DeviceId{0};
+		FDsCalibrationCacheEntry Entry;
+
+		DsCalibrationCache::SerializeEntry(Reader, DeviceId, Entry);
+
+		if (!Reader.IsError())
+		{
+			Entries.Emplace(DeviceId, Entry);
+		}
+	}
+
+	UE_LOG(LogFabulousDualSense, Verbose, TEXT("Calibration cache loaded, Entries: %d."), Entries.Num());
+}
+
+void FDsCalibrationCache::Save(const bool bSynchronous)
+{
+	bDirty = false;
+	NextSaveTime = FPlatformTime::Seconds() + DsCalibrationCache::SaveInterval;
+	SaveNumber += 1;
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer{Data};
+
+	auto Magic{DsCalibrationCache::FileMagic};
+	auto Version{DsCalibrationCache::FileVersion};
+	uint32 Crc{0};
+	auto EntriesCount{Entries.Num()};
+
+	Writer << Magic << Version << Crc;
+
+	const auto PayloadOffset{Writer.Tell()};
+
+	Writer << EntriesCount;
+
+	for (auto& [DeviceId, Entry] : Entries)
+	{
+		auto EntryDeviceId{DeviceId};
+		DsCalibrationCache::SerializeEntry(Writer, EntryDeviceId, Entry);
+	}
+
+	Crc = FCrc::MemCrc32(Data.GetData() + PayloadOffset, static_cast<int32>(Data.Num() - PayloadOffset));
+
+	Writer.Seek(PayloadOffset - sizeof(Crc));
+	Writer << Crc;
+
+	if (bSynchronous)
+	{
+		Write(*SaveState, SaveNumber, Data, GetFilePath());
+		return;
+	}
+
+	// Only the serialization happens on the game thread, the file is written in the background.
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [State{SaveState}, Number{SaveNumber}, Data{MoveTemp(Data)}, FilePath{GetFilePath()}]
+	{
+		Write(*State, Number, Data, FilePath);
+	}, LowLevelTasks::ETaskPriority::BackgroundNormal);
+}
+
+void FDsCalibrationCache::Write(FSaveState& State, const uint64 Number, const TArray<uint8>& Data, const FString& FilePath)
+{
+	FScopeLock Lock{&State.CriticalSection};
+
+	if (Number <= State.WrittenSaveNumber)
+	{
+		return;
+	}
+
+	State.WrittenSaveNumber = Number;
+
+	if (!FFileHelper::SaveArrayToFile(Data, *FilePath))
+	{
+		UE_LOG(LogFabulousDualSense, Warning, TEXT("Failed to save calibration cache: %s."), *FilePath);
+	}
+}
+
+FString FDsCalibrationCache::GetFilePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("FabulousDualSense") / TEXT("CalibrationCache.bin");
+}
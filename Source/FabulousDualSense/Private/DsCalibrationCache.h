@@ -0,0 +1,99 @@
+#pragma once
+
+#include <DualSenseWindows.h>
+
+#include "DsImuCalibration.h"
+#include "Containers/Queue.h"
+#include "HAL/CriticalSection.h"
+
+struct FABULOUSDUALSENSE_API FDsCalibrationCacheEntry
+{
+	DS5W::DeviceCalibrationData CalibrationData{};
+
+	// Precompiled from the calibration data above.
+	FDsImuCalibration ImuCalibration;
+
+	// From the firmware info feature report, zero until it has been read at least once.
+
+	uint32 HardwareVersion{0};
+	uint32 FirmwareVersion{0};
+
+	// Estimated while the device was lying still, in degrees per second. Only valid for the calibration data above.
+	FVector3f GyroBias{ForceInit};
+
+	bool bHasGyroBias{false};
+};
+
+// Calibration data, firmware info and gyroscope bias of previously connected devices, keyed by the device unique ID and stored on disk.
+// Must only be accessed from the game thread, except for the firmware info requests, which are processed in the background.
+class FABULOUSDUALSENSE_API FDsCalibrationCache
+{
+private:
+	struct FFirmwareInfo
+	{
+		uint32 DeviceId{0};
+
+		uint32 HardwareVersion{0};
+		uint32 FirmwareVersion{0};
+	};
+
+	// Shared with the background saves, so that they can outlive the cache.
+	struct FSaveState
+	{
+		FCriticalSection CriticalSection;
+
+		// Saves are numbered, so that an outdated save that finishes late never overwrites a newer one.
+		uint64 WrittenSaveNumber{0};
+	};
+
+	TMap<uint32, FDsCalibrationCacheEntry> Entries;
+
+	TSharedRef<TQueue<FFirmwareInfo, EQueueMode::Mpsc>, ESPMode::ThreadSafe> FirmwareInfoQueue{
+		MakeShared<TQueue<FFirmwareInfo, EQueueMode::Mpsc>, ESPMode::ThreadSafe>()
+	};
+
+	TSharedRef<FSaveState, ESPMode::ThreadSafe> SaveState{MakeShared<FSaveState, ESPMode::ThreadSafe>()};
+
+	uint64 SaveNumber{0};
+
+	double NextSaveTime{0.0};
+
+	uint8 bDirty : 1 {false};
+
+public:
+	FDsCalibrationCache();
+
+	~FDsCalibrationCache();
+
+	// Provides the precompiled IMU calibration for the given calibration data, reusing the cached one if the
+	// calibration data didn't change. Invalid calibration data, which the device sometimes returns over
+	// Bluetooth, is replaced with the cached one if there is any. Also requests a firmware info refresh.
+	void ResolveCalibration(uint32 DeviceId, const TCHAR* DevicePath,
+	                        DS5W::DeviceCalibrationData& CalibrationData, FDsImuCalibration& ImuCalibration);
+
+	// Returns false if no bias has been estimated for the device yet.
+	bool GetGyroBias(uint32 DeviceId, FVector3f& GyroBias) const;
+
+	void SetGyroBias(uint32 DeviceId, const FVector3f& GyroBias);
+
+	// Applies the finished firmware info requests and, if the cache changed, saves it in the background, at most once per save interval.
+	void Update();
+
+	FDsCalibrationCache(const FDsCalibrationCache&) = delete;
+
+	FDsCalibrationCache& operator=(const FDsCalibrationCache&) = delete;
+
+private:
+	void RequestFirmwareInfo(uint32 DeviceId, const TCHAR* DevicePath);
+
+	void ApplyFirmwareInfo();
+
+	void Load();
+
+	// Serializes the cache on the calling thread and writes it either right away or in the background.
+	void Save(bool bSynchronous);
+
+	static void Write(FSaveState& State, uint64 Number, const TArray<uint8>& Data, const FString& FilePath);
+
+	static FString GetFilePath();
+};
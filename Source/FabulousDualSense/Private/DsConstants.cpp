@@ -1,57 +1,73 @@
 ﻿#include "DsConstants.h"
 
-#include <DualSenseWindows.h>
+#include "DsKeys.h"
 
 const FName DsConstants::InputDeviceName{TEXTVIEW("DsInputDevice")};
 const FString DsConstants::HardwareDeviceIdentifier{TEXTVIEW("DualSense")};
 
-const FKey DsConstants::TouchpadKey{FName{TEXTVIEW("DsTouchpad")}};
-const FKey DsConstants::LogoKey{FName{TEXTVIEW("DsLogo")}};
-const FKey DsConstants::MuteKey{FName{TEXTVIEW("DsMute")}};
+// The keys are defined from the key table, which fails to compile if any of them is missing from it.
 
-const FKey DsConstants::Touch1Key{FName{TEXTVIEW("DsTouch1")}};
-const FKey DsConstants::Touch1AxisXKey{FName{TEXTVIEW("DsTouch1AxisX")}};
-const FKey DsConstants::Touch1AxisYKey{FName{TEXTVIEW("DsTouch1AxisY")}};
-const FKey DsConstants::Touch1AxisXYKey{FName{TEXTVIEW("DsTouch1AxisXY")}};
+const FKey DsConstants::TouchpadKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsTouchpad"))].Name};
+const FKey DsConstants::LogoKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsLogo"))].Name};
+const FKey DsConstants::MuteKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsMute"))].Name};
 
-const FKey DsConstants::Touch2Key{FName{TEXTVIEW("DsTouch2")}};
-const FKey DsConstants::Touch2AxisXKey{FName{TEXTVIEW("DsTouch2AxisX")}};
-const FKey DsConstants::Touch2AxisYKey{FName{TEXTVIEW("DsTouch2AxisY")}};
-const FKey DsConstants::Touch2AxisXYKey{FName{TEXTVIEW("DsTouch2AxisXY")}};
+const FKey DsConstants::LeftFunctionKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsLeftFunction"))].Name};
+const FKey DsConstants::RightFunctionKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsRightFunction"))].Name};
+const FKey DsConstants::LeftPaddleKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsLeftPaddle"))].Name};
+const FKey DsConstants::RightPaddleKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsRightPaddle"))].Name};
 
-const FKey DsConstants::GyroscopeAxisRollKey{FName{TEXTVIEW("DsGyroscopeRoll")}};
-const FKey DsConstants::GyroscopeAxisPitchKey{FName{TEXTVIEW("DsGyroscopePitch")}};
-const FKey DsConstants::GyroscopeAxisYawKey{FName{TEXTVIEW("DsGyroscopeYaw")}};
-const FKey DsConstants::GyroscopeAxisYawPitchKey{FName{TEXTVIEW("DsGyroscopeYawPitch")}};
+const FKey DsConstants::Touch1Key{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsTouch1"))].Name};
+const FKey DsConstants::Touch1AxisXKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsTouch1AxisX"))].Name};
+const FKey DsConstants::Touch1AxisYKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsTouch1AxisY"))].Name};
+const FKey DsConstants::Touch1AxisXYKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsTouch1AxisXY"))].Name};
 
-const TMap<FGamepadKeyNames::Type, uint32>& DsConstants::GetRegularButtons()
-{
-	static const TMap<FGamepadKeyNames::Type, uint32> Buttons{
-		{FGamepadKeyNames::DPadUp, DS5W_ISTATE_BTN_DPAD_UP},
-		{FGamepadKeyNames::DPadDown, DS5W_ISTATE_BTN_DPAD_DOWN},
-		{FGamepadKeyNames::DPadLeft, DS5W_ISTATE_BTN_DPAD_LEFT},
-		{FGamepadKeyNames::DPadRight, DS5W_ISTATE_BTN_DPAD_RIGHT},
+const FKey DsConstants::Touch2Key{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsTouch2"))].Name};
+const FKey DsConstants::Touch2AxisXKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsTouch2AxisX"))].Name};
+const FKey DsConstants::Touch2AxisYKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsTouch2AxisY"))].Name};
+const FKey DsConstants::Touch2AxisXYKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsTouch2AxisXY"))].Name};
+
+const FKey DsConstants::GyroscopeAxisRollKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsGyroscopeRoll"))].Name};
+const FKey DsConstants::GyroscopeAxisPitchKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsGyroscopePitch"))].Name};
+const FKey DsConstants::GyroscopeAxisYawKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsGyroscopeYaw"))].Name};
+const FKey DsConstants::GyroscopeAxisYawPitchKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsGyroscopeYawPitch"))].Name};
 
-		{FGamepadKeyNames::FaceButtonTop, DS5W_ISTATE_BTN_TRIANGLE},
-		{FGamepadKeyNames::FaceButtonBottom, DS5W_ISTATE_BTN_CROSS},
-		{FGamepadKeyNames::FaceButtonLeft, DS5W_ISTATE_BTN_SQUARE},
-		{FGamepadKeyNames::FaceButtonRight, DS5W_ISTATE_BTN_CIRCLE},
+const FKey DsConstants::AccelerometerAxisXKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsAccelerometerX"))].Name};
+const FKey DsConstants::AccelerometerAxisYKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsAccelerometerY"))].Name};
+const FKey DsConstants::AccelerometerAxisZKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsAccelerometerZ"))].Name};
 
-		{FGamepadKeyNames::LeftTriggerThreshold, DS5W_ISTATE_BTN_TRIGGER_LEFT},
-		{FGamepadKeyNames::RightTriggerThreshold, DS5W_ISTATE_BTN_TRIGGER_RIGHT},
+const FKey DsConstants::GravityAxisXKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsGravityX"))].Name};
+const FKey DsConstants::GravityAxisYKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsGravityY"))].Name};
+const FKey DsConstants::GravityAxisZKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsGravityZ"))].Name};
 
-		{FGamepadKeyNames::LeftShoulder, DS5W_ISTATE_BTN_BUMPER_LEFT},
-		{FGamepadKeyNames::RightShoulder, DS5W_ISTATE_BTN_BUMPER_RIGHT},
+const FKey DsConstants::GyroAimAxisXKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsGyroAimX"))].Name};
+const FKey DsConstants::GyroAimAxisYKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsGyroAimY"))].Name};
+const FKey DsConstants::GyroAimAxisXYKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsGyroAimXY"))].Name};
 
-		{FGamepadKeyNames::LeftThumb, DS5W_ISTATE_BTN_STICK_LEFT},
-		{FGamepadKeyNames::RightThumb, DS5W_ISTATE_BTN_STICK_RIGHT},
+const FKey DsConstants::ShakeKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsShake"))].Name};
+const FKey DsConstants::FlickLeftKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsFlickLeft"))].Name};
+const FKey DsConstants::FlickRightKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsFlickRight"))].Name};
+const FKey DsConstants::FlickUpKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsFlickUp"))].Name};
+const FKey DsConstants::FlickDownKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsFlickDown"))].Name};
+const FKey DsConstants::FaceDownKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsFaceDown"))].Name};
+const FKey DsConstants::UprightKey{DsKeys::Descriptors[DsKeys::GetKeyIndex(TEXT("DsUpright"))].Name};
+
+const TMap<FGamepadKeyNames::Type, uint32>& DsConstants::GetRegularButtons()
+{
+	static const auto Buttons{
+		[]
+		{
+			TMap<FGamepadKeyNames::Type, uint32> Result;
 
-		{FGamepadKeyNames::SpecialLeft, DS5W_ISTATE_BTN_SELECT},
-		{FGamepadKeyNames::SpecialRight, DS5W_ISTATE_BTN_MENU},
+			for (const auto& Descriptor : DsKeys::Descriptors)
+			{
+				if (Descriptor.Source == EDsKeySource::ButtonMap && !Descriptor.bEdgeOnly)
+				{
+					Result.Emplace(FName{Descriptor.Name}, Descriptor.ButtonFlag);
+				}
+			}
 
-		{TouchpadKey.GetFName(), DS5W_ISTATE_BTN_PAD_BUTTON},
-		{LogoKey.GetFName(), DS5W_ISTATE_BTN_PLAYSTATION_LOGO},
-		{MuteKey.GetFName(), DS5W_ISTATE_BTN_MIC_BUTTON},
+			return Result;
+		}()
 	};
 
 	return Buttons;
@@ -0,0 +1,163 @@
+#include "DsDeviceEnumeration.h"
+
+#include "DsUtility.h"
+#include "Misc/Crc.h"
+#include "Misc/ScopeExit.h"
+
+#include "Windows/AllowWindowsPlatformTypes.h"
+
+#include <SetupAPI.h>
+#include <hidsdi.h>
+
+#include "Windows/HideWindowsPlatformTypes.h"
+
+namespace DsDeviceEnumeration
+{
+	// Returns false if the device could not be opened, which is usually temporary.
+	bool QueryDeviceAttributes(const TCHAR* DevicePath, uint16& VendorId, uint16& ProductId, int32& InputReportSize)
+	{
+		// Opening the device without access rights is enough to query
+		// its attributes, and doesn't conflict with other applications.
+
+		const auto DeviceHandle{
+			CreateFileW(DevicePath, 0, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr)
+		};
+
+		if (DeviceHandle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		ON_SCOPE_EXIT
+		{
+			CloseHandle(DeviceHandle);
+		};
+
+		HIDD_ATTRIBUTES Attributes{.Size = sizeof(HIDD_ATTRIBUTES)};
+		if (!HidD_GetAttributes(DeviceHandle, &Attributes))
+		{
+			return false;
+		}
+
+		VendorId = Attributes.VendorID;
+		ProductId = Attributes.ProductID;
+
+		PHIDP_PREPARSED_DATA PreparsedData{nullptr};
+		if (!HidD_GetPreparsedData(DeviceHandle, &PreparsedData))
+		{
+			return false;
+		}
+
+		HIDP_CAPS Caps{};
+		const auto CapsResult{HidP_GetCaps(PreparsedData, &Caps)};
+
+		HidD_FreePreparsedData(PreparsedData);
+
+		if (CapsResult != HIDP_STATUS_SUCCESS)
+		{
+			return false;
+		}
+
+		InputReportSize = Caps.InputReportByteLength;
+		return true;
+	}
+}
+
+bool FDsDeviceEnumerator::EnumerateUnknownDevices(const TConstArrayView<uint32> KnownDeviceIds,
+                                                  const TArrayView<FDsDeviceInfo> DeviceInfos, int32& DevicesCount)
+{
+	DevicesCount = 0;
+
+	GUID HidGuid;
+	HidD_GetHidGuid(&HidGuid);
+
+	const auto DeviceInfoSet{SetupDiGetClassDevsW(&HidGuid, nullptr, nullptr, DIGCF_DEVICEINTERFACE | DIGCF_PRESENT)};
+	if (DeviceInfoSet == INVALID_HANDLE_VALUE)
+	{
+		UE_LOG(LogFabulousDualSense, Warning, TEXT("Failed to enumerate devices: %u."), GetLastError());
+		return false;
+	}
+
+	ON_SCOPE_EXIT
+	{
+		SetupDiDestroyDeviceInfoList(DeviceInfoSet);
+	};
+
+	SP_DEVICE_INTERFACE_DATA InterfaceData{.cbSize = sizeof(SP_DEVICE_INTERFACE_DATA)};
+
+	struct
+	{
+		SP_DEVICE_INTERFACE_DETAIL_DATA_W Data;
+		WCHAR Path[MAX_PATH];
+	} InterfaceDetail;
+
+	for (::DWORD InterfaceIndex{0};
+	     DevicesCount < DeviceInfos.Num() && SetupDiEnumDeviceInterfaces(DeviceInfoSet, nullptr, &HidGuid, InterfaceIndex, &InterfaceData);
+	     InterfaceIndex++)
+	{
+		InterfaceDetail.Data.cbSize = sizeof(SP_DEVICE_INTERFACE_DETAIL_DATA_W);
+
+		if (!SetupDiGetDeviceInterfaceDetailW(DeviceInfoSet, &InterfaceData, &InterfaceDetail.Data,
+		                                      sizeof(InterfaceDetail), nullptr, nullptr))
+		{
+			continue;
+		}
+
+		const auto* DevicePath{InterfaceDetail.Data.DevicePath};
+		const auto DevicePathLength{FCString::Strlen(DevicePath)};
+
+		if (DevicePathLength >= MAX_PATH)
+		{
+			// The path doesn't fit into DS5W::DeviceEnumInfo.
+			continue;
+		}
+
+		const auto DeviceId{FCrc::MemCrc32(DevicePath, DevicePathLength * sizeof(TCHAR))};
+
+		if (KnownDeviceIds.Contains(DeviceId) || IgnoredDeviceIds.Contains(DeviceId))
+		{
+			continue;
+		}
+
+		uint16 VendorId;
+		uint16 ProductId;
+		int32 InputReportSize;
+
+		if (!DsDeviceEnumeration::QueryDeviceAttributes(DevicePath, VendorId, ProductId, InputReportSize))
+		{
+			continue;
+		}
+
+		// The largest input report is only available over Bluetooth.
+
+		const auto* Binding{DsDeviceModels::FindBinding(VendorId, ProductId, DS5W::DeviceConnection::BT)};
+		if (Binding != nullptr && InputReportSize < Binding->InputReportSize)
+		{
+			Binding = &DsDeviceModels::GetBinding(Binding->Model, DS5W::DeviceConnection::USB);
+		}
+
+		if (Binding == nullptr || !Binding->bSupportedByLibrary)
+		{
+			if (Binding != nullptr)
+			{
+				UE_LOG(LogFabulousDualSense, Log, TEXT("Unsupported device found: %s, Model: %s, Connection: %s."), DevicePath,
+				       DsUtility::DeviceModelToString(Binding->Model).GetData(),
+				       DsUtility::DeviceConnectionToString(Binding->Connection).GetData());
+			}
+
+			IgnoredDeviceIds.Add(DeviceId);
+			continue;
+		}
+
+		auto& DeviceInfo{DeviceInfos[DevicesCount]};
+		DevicesCount += 1;
+
+		FMemory::Memcpy(DeviceInfo.EnumInfo._internal.path, DevicePath, (DevicePathLength + 1) * sizeof(TCHAR));
+		DeviceInfo.EnumInfo._internal.connection = Binding->Connection;
+		DeviceInfo.EnumInfo._internal.uniqueID = DeviceId;
+
+		DeviceInfo.Binding = Binding;
+	}
+
+	return true;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <DualSenseWindows.h>
+
+#include "DsDeviceModels.h"
+
+struct FABULOUSDUALSENSE_API FDsDeviceInfo
+{
+	DS5W::DeviceEnumInfo EnumInfo{};
+
+	const FDsDeviceModelBinding* Binding{nullptr};
+};
+
+// Replacement for enumUnknownDevices() that recognizes all device models from DsDeviceModels
+// instead of only DualSense, and binds each found device to its model and connection.
+class FABULOUSDUALSENSE_API FDsDeviceEnumerator
+{
+private:
+	// HID devices that are not supported controllers. They are never opened again, since device interface paths are stable.
+	TSet<uint32> IgnoredDeviceIds;
+
+public:
+	// Returns false if the enumeration failed. Devices with known IDs are skipped without being
+	// opened. If there are more devices than the array can fit, the remaining devices are skipped.
+	bool EnumerateUnknownDevices(TConstArrayView<uint32> KnownDeviceIds, TArrayView<FDsDeviceInfo> DeviceInfos, int32& DevicesCount);
+};
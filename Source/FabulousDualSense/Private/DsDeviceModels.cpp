@@ -0,0 +1,213 @@
+#include "DsDeviceModels.h"
+
+#include "DsReport.h"
+
+namespace DsDeviceModels
+{
+	template <typename Descriptor, DS5W::DeviceConnection Connection>
+	void DecodeInputReport(const uint8* Report, const FDsImuCalibration& ImuCalibration, uint8& SequenceNumber,
+	                       DS5W::DS5InputState& Input, FDsMotionState& Motion)
+	{
+		const auto* ReportBody{
+			Report + (Connection == DS5W::DeviceConnection::BT ? Descriptor::BluetoothReportBodyOffset : Descriptor::UsbReportBodyOffset)
+		};
+
+		// Sticks.
+
+		Input.leftStick.x = static_cast<char>(static_cast<int32>(ReportBody[Descriptor::LeftStickOffset]) - 128);
+		Input.leftStick.y = static_cast<char>(127 - static_cast<int32>(ReportBody[Descriptor::LeftStickOffset + 1]));
+
+		Input.rightStick.x = static_cast<char>(static_cast<int32>(ReportBody[Descriptor::RightStickOffset]) - 128);
+		Input.rightStick.y = static_cast<char>(127 - static_cast<int32>(ReportBody[Descriptor::RightStickOffset + 1]));
+
+		// Triggers.
+
+		Input.leftTrigger = ReportBody[Descriptor::LeftTriggerOffset];
+		Input.rightTrigger = ReportBody[Descriptor::RightTriggerOffset];
+
+		// Sequence number. Narrower counters are extended by accumulating their
+		// deltas, which keeps the wraparound at 256 expected by the link quality tracker.
+
+		static constexpr uint8 SequenceNumberMask{0xFF >> Descriptor::SequenceNumberShift};
+
+		const auto NewSequenceNumber{static_cast<uint8>(ReportBody[Descriptor::SequenceNumberOffset] >> Descriptor::SequenceNumberShift)};
+
+		SequenceNumber = static_cast<uint8>(SequenceNumber + ((NewSequenceNumber - SequenceNumber) & SequenceNumberMask));
+
+		// Buttons. The D-pad direction is converted to flags.
+
+		static constexpr uint8 DpadFlags[16]{
+			DS5W_ISTATE_BTN_DPAD_UP,
+			DS5W_ISTATE_BTN_DPAD_UP | DS5W_ISTATE_BTN_DPAD_RIGHT,
+			DS5W_ISTATE_BTN_DPAD_RIGHT,
+			DS5W_ISTATE_BTN_DPAD_DOWN | DS5W_ISTATE_BTN_DPAD_RIGHT,
+			DS5W_ISTATE_BTN_DPAD_DOWN,
+			DS5W_ISTATE_BTN_DPAD_DOWN | DS5W_ISTATE_BTN_DPAD_LEFT,
+			DS5W_ISTATE_BTN_DPAD_LEFT,
+			DS5W_ISTATE_BTN_DPAD_UP | DS5W_ISTATE_BTN_DPAD_LEFT,
+		};
+
+		const auto* Buttons{ReportBody + Descriptor::ButtonsOffset};
+
+		Input.buttonMap = DpadFlags[Buttons[0] & 0x0F] |
+		                  (Buttons[0] & 0xF0) |
+		                  static_cast<uint32>(Buttons[1]) << 8 |
+		                  static_cast<uint32>(Buttons[2] & Descriptor::ExtraButtonsMask) << 16;
+
+		// Motion sensors.
+
+		int16 RawImuValues[FDsImuCalibration::AxesCount];
+
+		for (auto i{0}; i < FDsImuCalibration::AxesCount; i++)
+		{
+			RawImuValues[i] = DsReport::ReadInt16(ReportBody + Descriptor::ImuOffset + i * 2);
+		}
+
+		int32 CalibratedImuValues[FDsImuCalibration::AxesCount];
+		float PhysicalImuValues[FDsImuCalibration::AxesCount];
+
+		ImuCalibration.Calibrate(RawImuValues, CalibratedImuValues, PhysicalImuValues);
+
+		Input.gyroscope = {CalibratedImuValues[0], CalibratedImuValues[1], CalibratedImuValues[2]};
+		Input.accelerometer = {CalibratedImuValues[3], CalibratedImuValues[4], CalibratedImuValues[5]};
+
+		Motion.Gyroscope = {PhysicalImuValues[0], PhysicalImuValues[1], PhysicalImuValues[2]};
+		Motion.Accelerometer = {PhysicalImuValues[3], PhysicalImuValues[4], PhysicalImuValues[5]};
+
+		// Sensor timestamp, converted to 0.33 microseconds. Narrower timestamps are extended the same way as the sequence number.
+
+		const auto* SensorTimestampData{ReportBody + Descriptor::SensorTimestampOffset};
+
+		if constexpr (Descriptor::SensorTimestampSize == 4)
+		{
+			const auto SensorTimestamp{DsReport::ReadUInt32(SensorTimestampData) * Descriptor::SensorTimestampScale};
+
+			Input.deltaTime = SensorTimestamp - Input.currentTime;
+			Input.currentTime = SensorTimestamp;
+		}
+		else
+		{
+			const auto PreviousSensorTimestamp{static_cast<uint16>(Input.currentTime / Descriptor::SensorTimestampScale)};
+			const auto SensorTimestampDelta{static_cast<uint16>(DsReport::ReadUInt16(SensorTimestampData) - PreviousSensorTimestamp)};
+
+			Input.deltaTime = SensorTimestampDelta * Descriptor::SensorTimestampScale;
+			Input.currentTime += Input.deltaTime;
+		}
+
+		// Touch pad.
+
+		const auto DecodeTouch{
+			[](const uint8* Data, DS5W::Touch& Touch)
+			{
+				const auto RawTouch{DsReport::ReadUInt32(Data)};
+
+				Touch.down = (RawTouch & 0x80) == 0;
+				Touch.id = static_cast<unsigned char>(RawTouch & 0x7F);
+				Touch.x = (RawTouch & 0xFFF00) >> 8;
+				Touch.y = RawTouch >> 20;
+			}
+		};
+
+		DecodeTouch(ReportBody + Descriptor::TouchPoint1Offset, Input.touchPoint1);
+		DecodeTouch(ReportBody + Descriptor::TouchPoint2Offset, Input.touchPoint2);
+
+		// Trigger feedback.
+
+		if constexpr (Descriptor::LeftTriggerFeedbackOffset != INDEX_NONE)
+		{
+			Input.leftTriggerFeedback = ReportBody[Descriptor::LeftTriggerFeedbackOffset];
+			Input.rightTriggerFeedback = ReportBody[Descriptor::RightTriggerFeedbackOffset];
+		}
+
+		// Battery and headphones.
+
+		const auto Status{ReportBody[Descriptor::StatusOffset]};
+
+		Input.battery.level = Status & 0x0F;
+
+		if constexpr (Descriptor::bStatusHasChargingState)
+		{
+			Input.battery.charging = (Status >> 4) == 0x01;
+			Input.battery.fullyCharged = (Status >> 4) == 0x02;
+		}
+		else
+		{
+			// The battery level goes above 10 when the battery is fully charged.
+
+			const auto bCableConnected{(Status & 0x10) != 0};
+
+			Input.battery.charging = bCableConnected && Input.battery.level <= 10;
+			Input.battery.fullyCharged = bCableConnected && Input.battery.level > 10;
+		}
+
+		Input.headPhoneConnected = (ReportBody[Descriptor::HeadphonesOffset] & Descriptor::HeadphonesMask) != 0;
+	}
+
+	template <typename Descriptor, DS5W::DeviceConnection Connection>
+	constexpr FDsDeviceModelBinding MakeBinding()
+	{
+		return {
+			Descriptor::Model,
+			Connection,
+			Descriptor::bSupportedByLibrary,
+			Connection == DS5W::DeviceConnection::BT ? Descriptor::BluetoothInputReportId : Descriptor::UsbInputReportId,
+			Connection == DS5W::DeviceConnection::BT ? Descriptor::BluetoothInputReportSize : Descriptor::UsbInputReportSize,
+			&DecodeInputReport<Descriptor, Connection>
+		};
+	}
+
+	template <typename Descriptor>
+	bool MatchesDescriptor(const uint16 VendorId, const uint16 ProductId)
+	{
+		if (VendorId != Descriptor::VendorId)
+		{
+			return false;
+		}
+
+		for (const auto DescriptorProductId : Descriptor::ProductIds)
+		{
+			if (ProductId == DescriptorProductId)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Indexed by the model and the connection.
+	static constexpr FDsDeviceModelBinding Bindings[]{
+		MakeBinding<FDsDualSenseDescriptor, DS5W::DeviceConnection::USB>(),
+		MakeBinding<FDsDualSenseDescriptor, DS5W::DeviceConnection::BT>(),
+		MakeBinding<FDsDualSenseEdgeDescriptor, DS5W::DeviceConnection::USB>(),
+		MakeBinding<FDsDualSenseEdgeDescriptor, DS5W::DeviceConnection::BT>(),
+		MakeBinding<FDsDualShock4Descriptor, DS5W::DeviceConnection::USB>(),
+		MakeBinding<FDsDualShock4Descriptor, DS5W::DeviceConnection::BT>(),
+	};
+}
+
+const FDsDeviceModelBinding* DsDeviceModels::FindBinding(const uint16 VendorId, const uint16 ProductId,
+                                                         const DS5W::DeviceConnection Connection)
+{
+	if (MatchesDescriptor<FDsDualSenseDescriptor>(VendorId, ProductId))
+	{
+		return &GetBinding(EDsDeviceModel::DualSense, Connection);
+	}
+
+	if (MatchesDescriptor<FDsDualSenseEdgeDescriptor>(VendorId, ProductId))
+	{
+		return &GetBinding(EDsDeviceModel::DualSenseEdge, Connection);
+	}
+
+	if (MatchesDescriptor<FDsDualShock4Descriptor>(VendorId, ProductId))
+	{
+		return &GetBinding(EDsDeviceModel::DualShock4, Connection);
+	}
+
+	return nullptr;
+}
+
+const FDsDeviceModelBinding& DsDeviceModels::GetBinding(const EDsDeviceModel Model, const DS5W::DeviceConnection Connection)
+{
+	return Bindings[static_cast<int32>(Model) * 2 + (Connection == DS5W::DeviceConnection::BT ? 1 : 0)];
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <DualSenseWindows.h>
+
+#include "DsImuCalibration.h"
+
+enum class EDsDeviceModel : uint8
+{
+	DualSense,
+	DualSenseEdge,
+	DualShock4
+};
+
+// Compile-time descriptions of the supported controller models. All offsets are
+// relative to the beginning of the report body, INDEX_NONE means the field is absent.
+
+struct FDsDualSenseDescriptor
+{
+	static constexpr auto Model{EDsDeviceModel::DualSense};
+
+	static constexpr uint16 VendorId{SONY_CORP_VENDOR_ID};
+	static constexpr uint16 ProductIds[]{DUALSENSE_CONTROLLER_PROD_ID};
+
+	// Whether DualSenseWindows is able to initialize the device and write its output reports.
+	static constexpr auto bSupportedByLibrary{true};
+
+	static constexpr uint8 UsbInputReportId{DS_INPUT_REPORT_USB};
+	static constexpr int32 UsbInputReportSize{DS_INPUT_REPORT_USB_SIZE};
+	static constexpr int32 UsbReportBodyOffset{1};
+
+	static constexpr uint8 BluetoothInputReportId{DS_INPUT_REPORT_BT};
+	static constexpr int32 BluetoothInputReportSize{DS_INPUT_REPORT_BT_SIZE};
+	static constexpr int32 BluetoothReportBodyOffset{2};
+
+	static constexpr int32 LeftStickOffset{0x00};
+	static constexpr int32 RightStickOffset{0x02};
+	static constexpr int32 LeftTriggerOffset{0x04};
+	static constexpr int32 RightTriggerOffset{0x05};
+
+	static constexpr int32 SequenceNumberOffset{0x06};
+	static constexpr int32 SequenceNumberShift{0};
+
+	// The first byte contains the D-pad direction in the lower nibble and face buttons in the upper nibble, the
+	// second byte contains shoulder, menu and stick buttons, and the third byte contains the extra buttons.
+	static constexpr int32 ButtonsOffset{0x07};
+	static constexpr uint8 ExtraButtonsMask{0x07};
+
+	// Gyroscope X, Y, Z followed by accelerometer X, Y, Z.
+	static constexpr int32 ImuOffset{0x0F};
+
+	static constexpr int32 SensorTimestampOffset{0x1B};
+	static constexpr int32 SensorTimestampSize{4};
+
+	// Converts the sensor timestamp to 0.33 microseconds.
+	static constexpr uint32 SensorTimestampScale{1};
+
+	static constexpr int32 TouchPoint1Offset{0x20};
+	static constexpr int32 TouchPoint2Offset{0x24};
+
+	static constexpr int32 LeftTriggerFeedbackOffset{0x29};
+	static constexpr int32 RightTriggerFeedbackOffset{0x2A};
+
+	// The lower nibble contains the battery level, the upper nibble contains the charging state.
+	static constexpr int32 StatusOffset{0x34};
+	static constexpr auto bStatusHasChargingState{true};
+
+	static constexpr int32 HeadphonesOffset{0x35};
+	static constexpr uint8 HeadphonesMask{0x01};
+};
+
+struct FDsDualSenseEdgeDescriptor : FDsDualSenseDescriptor
+{
+	static constexpr auto Model{EDsDeviceModel::DualSenseEdge};
+
+	static constexpr uint16 ProductIds[]{0x0DF2};
+
+	// Function buttons and back paddles.
+	static constexpr uint8 ExtraButtonsMask{0xF7};
+};
+
+struct FDsDualShock4Descriptor
+{
+	static constexpr auto Model{EDsDeviceModel::DualShock4};
+
+	static constexpr uint16 VendorId{SONY_CORP_VENDOR_ID};
+	static constexpr uint16 ProductIds[]{0x05C4, 0x09CC};
+
+	// DualSenseWindows reads DualSense-specific calibration and writes DualSense-specific output
+	// reports, so DualShock 4 input can be decoded, but the device can't be connected through it.
+	static constexpr auto bSupportedByLibrary{false};
+
+	static constexpr uint8 UsbInputReportId{0x01};
+	static constexpr int32 UsbInputReportSize{64};
+	static constexpr int32 UsbReportBodyOffset{1};
+
+	static constexpr uint8 BluetoothInputReportId{0x11};
+	static constexpr int32 BluetoothInputReportSize{78};
+	static constexpr int32 BluetoothReportBodyOffset{3};
+
+	static constexpr int32 LeftStickOffset{0x00};
+	static constexpr int32 RightStickOffset{0x02};
+	static constexpr int32 LeftTriggerOffset{0x07};
+	static constexpr int32 RightTriggerOffset{0x08};
+
+	// 6-bit report counter in the upper bits of the extra buttons byte.
+	static constexpr int32 SequenceNumberOffset{0x06};
+	static constexpr int32 SequenceNumberShift{2};
+
+	static constexpr int32 ButtonsOffset{0x04};
+	static constexpr uint8 ExtraButtonsMask{0x03};
+
+	static constexpr int32 ImuOffset{0x0C};
+
+	static constexpr int32 SensorTimestampOffset{0x09};
+	static constexpr int32 SensorTimestampSize{2};
+
+	// The sensor timestamp is measured in 5.33 microseconds.
+	static constexpr uint32 SensorTimestampScale{16};
+
+	static constexpr int32 TouchPoint1Offset{0x22};
+	static constexpr int32 TouchPoint2Offset{0x26};
+
+	static constexpr int32 LeftTriggerFeedbackOffset{INDEX_NONE};
+	static constexpr int32 RightTriggerFeedbackOffset{INDEX_NONE};
+
+	// The lower nibble contains the battery level, bit 4 indicates that the cable is connected.
+	static constexpr int32 StatusOffset{0x1D};
+	static constexpr auto bStatusHasChargingState{false};
+
+	static constexpr int32 HeadphonesOffset{0x1D};
+	static constexpr uint8 HeadphonesMask{0x20};
+};
+
+// Decodes the whole input report, including the report ID. The sequence number is updated
+// in place, so that counters narrower than 8 bits can be extended to the full 8 bits.
+using FDsInputReportDecoder = void (*)(const uint8* Report, const FDsImuCalibration& ImuCalibration, uint8& SequenceNumber,
+                                       DS5W::DS5InputState& Input, FDsMotionState& Motion);
+
+// Model and connection specific parameters that a device binds to once on connection.
+struct FABULOUSDUALSENSE_API FDsDeviceModelBinding
+{
+	EDsDeviceModel Model{EDsDeviceModel::DualSense};
+
+	DS5W::DeviceConnection Connection{DS5W::DeviceConnection::USB};
+
+	bool bSupportedByLibrary{false};
+
+	uint8 InputReportId{0};
+
+	int32 InputReportSize{0};
+
+	FDsInputReportDecoder DecodeInputReport{nullptr};
+};
+
+namespace DsDeviceModels
+{
+	FABULOUSDUALSENSE_API const FDsDeviceModelBinding* FindBinding(uint16 VendorId, uint16 ProductId, DS5W::DeviceConnection Connection);
+
+	FABULOUSDUALSENSE_API const FDsDeviceModelBinding& GetBinding(EDsDeviceModel Model, DS5W::DeviceConnection Connection);
+}
@@ -0,0 +1,25 @@
+#include "DsDeviceProperties.h"
+
+#include "DsInputDevice.h"
+#include "FabulousDualSenseModule.h"
+
+FName FDsPlayerLedsProperty::PropertyName()
+{
+	static const FName Name{TEXTVIEW("DsPlayerLeds")};
+	return Name;
+}
+
+FName FDsMicLedProperty::PropertyName()
+{
+	static const FName Name{TEXTVIEW("DsMicLed")};
+	return Name;
+}
+
+void DsDeviceProperties::SetDeviceProperties(const int32 ControllerId, const TConstArrayView<const FInputDeviceProperty*> Properties)
+{
+	const auto InputDevice{FFabulousDualSenseModule::GetInputDevice()};
+	if (InputDevice.IsValid())
+	{
+		InputDevice->SetDeviceProperties(ControllerId, Properties);
+	}
+}
@@ -0,0 +1,180 @@
+#include "DsGyroAim.h"
+
+#include "DsInputPrediction.h"
+#include "DsKeys.h"
+#include "DsSettings.h"
+
+void FDsGyroAimer::Reset()
+{
+	*this = FDsGyroAimer{};
+}
+
+void FDsGyroAimer::AddSample(const DS5W::DS5InputState& Input, const FDsMotionState& Motion,
+                             const float DeltaTime, const UDsSettings& Settings)
+{
+	if (!IsRatchetKeyDown(Input, Settings))
+	{
+		const auto AimVelocity{GetAimVelocity(Motion.Gyroscope, Motion.Gravity, Settings.GyroAimSpace)};
+		const auto Speed{AimVelocity.Size()};
+
+		auto Scale{GetSensitivity(Speed, Settings)};
+
+		// Slow rotations are scaled down instead of being cut off, so that there is no jump at the threshold.
+
+		if (Speed < Settings.GyroAimTighteningThreshold)
+		{
+			Scale *= Speed / Settings.GyroAimTighteningThreshold;
+		}
+
+		AimDelta += AimVelocity * (Scale * DeltaTime);
+	}
+
+	if (Settings.bEnableFlickStick)
+	{
+		UpdateFlickStick(Input, DeltaTime, Settings);
+	}
+}
+
+bool FDsGyroAimer::ConsumeAimDelta(FVector2f& Delta)
+{
+	if (AimDelta.IsZero())
+	{
+		return false;
+	}
+
+	Delta = AimDelta;
+	AimDelta = FVector2f::ZeroVector;
+
+	return true;
+}
+
+FVector2f FDsGyroAimer::GetAimVelocity(const FVector3f& Gyroscope, const FVector3f& Gravity, const EDsGyroAimSpace Space)
+{
+	// The gyroscope follows the right-hand rule, so its positive yaw is a turn to the left, unlike
+	// the camera yaw. The gravity vector points up, along the Y axis when the controller is lying flat.
+
+	const auto Up{Gravity.GetSafeNormal()};
+
+	if (Space == EDsGyroAimSpace::Local || Up.IsZero())
+	{
+		return {-Gyroscope.Y, Gyroscope.X};
+	}
+
+	if (Space == EDsGyroAimSpace::Player)
+	{
+		// The direction comes from the rotation around the gravity vector, but its speed is relaxed towards the
+		// combined yaw and roll velocity, so that players can turn either way without it feeling sluggish.
+
+		static constexpr auto YawRelaxFactor{1.41f};
+
+		const auto WorldYaw{Gyroscope.Y * Up.Y + Gyroscope.Z * Up.Z};
+		const auto Yaw{
+			FMath::Sign(WorldYaw) * FMath::Min(FMath::Abs(WorldYaw) * YawRelaxFactor, FVector2f{Gyroscope.Y, Gyroscope.Z}.Size())
+		};
+
+		return {-Yaw, Gyroscope.X};
+	}
+
+	// The pitch axis is the controller's X axis projected onto the horizontal plane. It becomes unreliable when
+	// the controller is held on its side, with the X axis pointing almost straight up, so the pitch is faded out there.
+
+	const auto PitchAxis{(FVector3f::XAxisVector - Up * Up.X).GetSafeNormal()};
+	const auto SideFactor{FMath::Clamp((FMath::Max(FMath::Abs(Up.Y), FMath::Abs(Up.Z)) - 0.125f) / 0.125f, 0.0f, 1.0f)};
+
+	return {-(Gyroscope | Up), (Gyroscope | PitchAxis) * SideFactor};
+}
+
+float FDsGyroAimer::GetSensitivity(const float Speed, const UDsSettings& Settings)
+{
+	const auto SpeedRange{Settings.GyroAimFastThreshold - Settings.GyroAimSlowThreshold};
+
+	const auto Alpha{
+		SpeedRange > UE_KINDA_SMALL_NUMBER
+			? FMath::Clamp((Speed - Settings.GyroAimSlowThreshold) / SpeedRange, 0.0f, 1.0f)
+			: Speed >= Settings.GyroAimFastThreshold ? 1.0f : 0.0f
+	};
+
+	return FMath::Lerp(Settings.GyroAimSlowSensitivity, Settings.GyroAimFastSensitivity,
+	                   FMath::Pow(Alpha, Settings.GyroAimAccelerationExponent));
+}
+
+bool FDsGyroAimer::IsRatchetKeyDown(const DS5W::DS5InputState& Input, const UDsSettings& Settings)
+{
+	const auto& KeyName{Settings.GyroAimRatchetKey.GetFName()};
+
+	if (KeyName != RatchetKeyName)
+	{
+		RatchetKeyName = KeyName;
+		RatchetKeyIndex = DsKeys::FindKeyIndex(KeyName);
+	}
+
+	return RatchetKeyIndex != INDEX_NONE && DsKeys::IsButtonDown(RatchetKeyIndex, Input);
+}
+
+void FDsGyroAimer::UpdateFlickStick(const DS5W::DS5InputState& Input, const float DeltaTime, const UDsSettings& Settings)
+{
+	// The release threshold is a bit lower than the tilt one, so that the stick
+	// resting on the edge of the threshold doesn't start a new flick on every report.
+
+	static constexpr auto ReleaseHysteresis{0.1f};
+
+	const FVector2f Stick{
+		FDsInputPredictor::NormalizeStickValue(Input.rightStick.x),
+		FDsInputPredictor::NormalizeStickValue(Input.rightStick.y)
+	};
+
+	const auto StickSize{Stick.Size()};
+
+	if (StickSize >= Settings.FlickStickThreshold)
+	{
+		const auto StickAngle{FMath::RadiansToDegrees(FMath::Atan2(Stick.X, Stick.Y))};
+
+		if (!bFlickStickTilted)
+		{
+			// Start a flick towards the direction of the stick.
+
+			bFlickStickTilted = true;
+			FlickAngle = StickAngle;
+			FlickElapsedTime = 0.0f;
+		}
+		else
+		{
+			// Rotating the tilted stick turns the camera by the same angle.
+
+			AimDelta.X += FMath::FindDeltaAngleDegrees(FlickStickAngle, StickAngle);
+		}
+
+		FlickStickAngle = StickAngle;
+	}
+	else if (StickSize < Settings.FlickStickThreshold - ReleaseHysteresis)
+	{
+		bFlickStickTilted = false;
+	}
+
+	if (FlickAngle == 0.0f)
+	{
+		return;
+	}
+
+	// The flick eases out, so that it starts fast and lands softly on the target direction.
+
+	const auto GetProgress{
+		[FlickTime{Settings.FlickStickTime}](const float ElapsedTime)
+		{
+			return FlickTime > 0.0f ? 1.0f - FMath::Square(1.0f - FMath::Min(ElapsedTime / FlickTime, 1.0f)) : 1.0f;
+		}
+	};
+
+	const auto PreviousProgress{FlickElapsedTime > 0.0f ? GetProgress(FlickElapsedTime) : 0.0f};
+
+	FlickElapsedTime += DeltaTime;
+
+	const auto Progress{GetProgress(FlickElapsedTime)};
+
+	AimDelta.X += FlickAngle * (Progress - PreviousProgress);
+
+	if (Progress >= 1.0f)
+	{
+		FlickAngle = 0.0f;
+	}
+}
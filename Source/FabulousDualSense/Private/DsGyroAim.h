@@ -0,0 +1,57 @@
+#pragma once
+
+#include <DualSenseWindows.h>
+
+#include "DsImuCalibration.h"
+
+enum class EDsGyroAimSpace : uint8;
+class UDsSettings;
+
+// Turns the gyroscope and the flick stick into a camera rotation on every input report, so that the acceleration
+// and the tightening see the real angular velocity instead of a frame average. The rotation is accumulated until
+// it's sent to the game once per frame.
+class FABULOUSDUALSENSE_API FDsGyroAimer
+{
+private:
+	// Degrees since the rotation was last consumed, the X component is the yaw to the right and the Y component is the pitch up.
+	FVector2f AimDelta{ForceInit};
+
+	// Flick stick.
+
+	// The direction of the tilted stick during the previous report, in degrees clockwise from up.
+	float FlickStickAngle{0.0f};
+
+	// The turn towards the stick direction, in degrees to the right.
+	float FlickAngle{0.0f};
+
+	float FlickElapsedTime{0.0f};
+
+	uint8 bFlickStickTilted : 1 {false};
+
+	// The ratchet key is looked up again only when the setting changes.
+
+	FName RatchetKeyName;
+
+	int32 RatchetKeyIndex{INDEX_NONE};
+
+public:
+	void Reset();
+
+	// Runs in constant time, so it can be called for every report.
+	void AddSample(const DS5W::DS5InputState& Input, const FDsMotionState& Motion, float DeltaTime, const UDsSettings& Settings);
+
+	// Returns false if the camera didn't rotate since the previous call.
+	bool ConsumeAimDelta(FVector2f& Delta);
+
+	// The angular velocity of the camera in degrees per second before the sensitivity is applied,
+	// the X component is the yaw to the right and the Y component is the pitch up.
+	static FVector2f GetAimVelocity(const FVector3f& Gyroscope, const FVector3f& Gravity, EDsGyroAimSpace Space);
+
+	// Camera degrees per controller degree at the given angular velocity in degrees per second.
+	static float GetSensitivity(float Speed, const UDsSettings& Settings);
+
+private:
+	bool IsRatchetKeyDown(const DS5W::DS5InputState& Input, const UDsSettings& Settings);
+
+	void UpdateFlickStick(const DS5W::DS5InputState& Input, float DeltaTime, const UDsSettings& Settings);
+};
@@ -0,0 +1,130 @@
+#include "DsGyroBias.h"
+
+#include "DsSettings.h"
+
+void FDsGyroBiasEstimator::Reset()
+{
+	*this = FDsGyroBiasEstimator{};
+}
+
+void FDsGyroBiasEstimator::SetBias(const FVector3f& NewBias)
+{
+	Bias = NewBias;
+	bHasBias = true;
+}
+
+bool FDsGyroBiasEstimator::GetBias(FVector3f& OutBias) const
+{
+	OutBias = Bias;
+	return bHasBias;
+}
+
+void FDsGyroBiasEstimator::AddSample(const FDsMotionState& Motion, const float DeltaTime, const UDsSettings& Settings)
+{
+	if (DeltaTime <= 0.0f)
+	{
+		return;
+	}
+
+	const FVector3d Gyroscope{Motion.Gyroscope};
+	const FVector3d Accelerometer{Motion.Accelerometer};
+
+	CurrentBlock.GyroscopeSum += Gyroscope;
+	CurrentBlock.GyroscopeSquaredSum += Gyroscope * Gyroscope;
+	CurrentBlock.AccelerometerSum += Accelerometer;
+	CurrentBlock.AccelerometerSquaredSum += Accelerometer * Accelerometer;
+	CurrentBlock.SamplesCount += 1;
+
+	CurrentBlockTime += DeltaTime;
+
+	if (CurrentBlockTime < Settings.GyroBiasStationaryWindow / BlocksCount)
+	{
+		return;
+	}
+
+	const auto BlockTime{CurrentBlockTime};
+
+	Blocks[BlockIndex] = CurrentBlock;
+	BlockIndex = (BlockIndex + 1) % BlocksCount;
+	FilledBlocksCount = FMath::Min(FilledBlocksCount + 1, BlocksCount);
+
+	CurrentBlock = FBlock{};
+	CurrentBlockTime = 0.0f;
+
+	if (FilledBlocksCount >= BlocksCount)
+	{
+		UpdateBias(BlockTime, Settings);
+	}
+}
+
+void FDsGyroBiasEstimator::Apply(DS5W::DS5InputState& Input, FDsMotionState& Motion) const
+{
+	if (!bHasBias)
+	{
+		return;
+	}
+
+	// The input state is in the calibrated sensor units, so the bias is rounded to them
+	// first to keep both states consistent with each other.
+
+	const auto BiasX{FMath::RoundToInt32(Bias.X * DS_GYRO_RES_PER_DEG_S)};
+	const auto BiasY{FMath::RoundToInt32(Bias.Y * DS_GYRO_RES_PER_DEG_S)};
+	const auto BiasZ{FMath::RoundToInt32(Bias.Z * DS_GYRO_RES_PER_DEG_S)};
+
+	Input.gyroscope.x -= BiasX;
+	Input.gyroscope.y -= BiasY;
+	Input.gyroscope.z -= BiasZ;
+
+	Motion.Gyroscope -= FVector3f{static_cast<float>(BiasX), static_cast<float>(BiasY), static_cast<float>(BiasZ)} / DS_GYRO_RES_PER_DEG_S;
+}
+
+void FDsGyroBiasEstimator::UpdateBias(const float BlockTime, const UDsSettings& Settings)
+{
+	FBlock Window;
+
+	for (const auto& Block : Blocks)
+	{
+		Window.GyroscopeSum += Block.GyroscopeSum;
+		Window.GyroscopeSquaredSum += Block.GyroscopeSquaredSum;
+		Window.AccelerometerSum += Block.AccelerometerSum;
+		Window.AccelerometerSquaredSum += Block.AccelerometerSquaredSum;
+		Window.SamplesCount += Block.SamplesCount;
+	}
+
+	const auto SamplesCount{static_cast<double>(Window.SamplesCount)};
+
+	const auto GyroscopeMean{Window.GyroscopeSum / SamplesCount};
+	const auto GyroscopeVariance{Window.GyroscopeSquaredSum / SamplesCount - GyroscopeMean * GyroscopeMean};
+
+	const auto AccelerometerMean{Window.AccelerometerSum / SamplesCount};
+	const auto AccelerometerVariance{Window.AccelerometerSquaredSum / SamplesCount - AccelerometerMean * AccelerometerMean};
+
+	// A steady rotation has as little variance as a controller lying still, so the mean is limited as well.
+
+	const auto bStationary{
+		GyroscopeVariance.GetMax() <= FMath::Square(Settings.GyroBiasMaxGyroscopeDeviation) &&
+		AccelerometerVariance.GetMax() <= FMath::Square(Settings.GyroBiasMaxAccelerometerDeviation) &&
+		GyroscopeMean.GetAbsMax() <= Settings.GyroBiasMaxOffset
+	};
+
+	if (!bStationary)
+	{
+		return;
+	}
+
+	const FVector3f Estimate{GyroscopeMean};
+
+	if (!bHasBias)
+	{
+		SetBias(Estimate);
+		return;
+	}
+
+	const auto Alpha{
+		Settings.GyroBiasTimeConstant > 0.0f
+			? BlockTime / (Settings.GyroBiasTimeConstant + BlockTime)
+			: 1.0f
+	};
+
+	Bias += (Estimate - Bias) * Alpha;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <DualSenseWindows.h>
+
+#include "DsImuCalibration.h"
+
+class UDsSettings;
+
+// Estimates the gyroscope bias from the periods when the controller is lying still, detected by the variance of the
+// gyroscope and the accelerometer over a sliding window. Must be fed with the gyroscope before the bias is subtracted.
+class FABULOUSDUALSENSE_API FDsGyroBiasEstimator
+{
+private:
+	// The window is split into blocks of samples, so that its statistics can be calculated
+	// from a few sums when a block is completed, instead of keeping every sample.
+	static constexpr auto BlocksCount{10};
+
+	struct FBlock
+	{
+		FVector3d GyroscopeSum{ForceInit};
+		FVector3d GyroscopeSquaredSum{ForceInit};
+
+		FVector3d AccelerometerSum{ForceInit};
+		FVector3d AccelerometerSquaredSum{ForceInit};
+
+		int32 SamplesCount{0};
+	};
+
+	FBlock Blocks[BlocksCount];
+
+	int32 BlockIndex{0};
+
+	int32 FilledBlocksCount{0};
+
+	FBlock CurrentBlock;
+
+	// Sensor time accumulated in the current block.
+	float CurrentBlockTime{0.0f};
+
+	// Degrees per second.
+	FVector3f Bias{ForceInit};
+
+	uint8 bHasBias : 1 {false};
+
+public:
+	// Also forgets the bias.
+	void Reset();
+
+	// Replaces the current estimate, for example with a cached one.
+	void SetBias(const FVector3f& NewBias);
+
+	// Returns false if the bias hasn't been estimated yet.
+	bool GetBias(FVector3f& OutBias) const;
+
+	// Runs in constant time, so it can be called for every report.
+	void AddSample(const FDsMotionState& Motion, float DeltaTime, const UDsSettings& Settings);
+
+	// Subtracts the bias from the gyroscope of both the input state and the motion state.
+	void Apply(DS5W::DS5InputState& Input, FDsMotionState& Motion) const;
+
+private:
+	void UpdateBias(float BlockTime, const UDsSettings& Settings);
+};
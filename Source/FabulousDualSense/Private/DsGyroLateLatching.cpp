@@ -0,0 +1,80 @@
+#include "DsGyroLateLatching.h"
+
+#include "DsInputSnapshot.h"
+#include "DsSettings.h"
+#include "RenderingThread.h"
+#include "SceneView.h"
+
+FDsGyroLateLatchingViewExtension::FDsGyroLateLatchingViewExtension(const FAutoRegister& AutoRegister)
+	: FSceneViewExtensionBase{AutoRegister} {}
+
+void FDsGyroLateLatchingViewExtension::SetupViewFamily(FSceneViewFamily& ViewFamily) {}
+
+void FDsGyroLateLatchingViewExtension::SetupView(FSceneViewFamily& ViewFamily, FSceneView& View) {}
+
+void FDsGyroLateLatchingViewExtension::BeginRenderViewFamily(FSceneViewFamily& ViewFamily)
+{
+	// Input has already been processed for this frame, so the current snapshot
+	// is the one that the game thread used to calculate the camera rotation.
+
+	const auto& Settings{*GetDefault<UDsSettings>()};
+
+	FSample Sample;
+
+	FDsInputSnapshot Snapshot;
+	if (DsInputSnapshot::Read(Settings.GyroLateLatchingControllerId, Snapshot))
+	{
+		Sample.ControllerId = Settings.GyroLateLatchingControllerId;
+		Sample.SequenceNumber = Snapshot.SequenceNumber;
+		Sample.IntegratedGyroscope = Snapshot.IntegratedGyroscope;
+		Sample.YawScale = Settings.GyroLateLatchingYawScale;
+		Sample.PitchScale = Settings.GyroLateLatchingPitchScale;
+	}
+
+	ENQUEUE_RENDER_COMMAND(DsGyroLateLatchingSample)(
+		[ViewExtension{StaticCastSharedRef<FDsGyroLateLatchingViewExtension>(AsShared())}, Sample](FRHICommandListImmediate&)
+		{
+			ViewExtension->RenderThreadSample = Sample;
+		});
+}
+
+void FDsGyroLateLatchingViewExtension::PreRenderView_RenderThread(FRDGBuilder& GraphBuilder, FSceneView& View)
+{
+	check(IsInRenderingThread());
+
+	if (RenderThreadSample.ControllerId == INDEX_NONE || View.bIsSceneCapture || View.bIsReflectionCapture || View.bIsPlanarReflection)
+	{
+		return;
+	}
+
+	// By the time the view is rendered, the game thread is usually already processing the next frame,
+	// so the snapshot most likely contains input reports that were received after the camera was updated.
+
+	FDsInputSnapshot Snapshot;
+	if (!DsInputSnapshot::Read(RenderThreadSample.ControllerId, Snapshot) || Snapshot.SequenceNumber <= RenderThreadSample.SequenceNumber)
+	{
+		return;
+	}
+
+	// Clamp the correction to protect against unexpected jumps, since it should only cover a frame or two of rotation.
+
+	static constexpr auto MaxCorrectionAngle{10.0f};
+
+	const auto DeltaPitch{FMath::UnwindDegrees(Snapshot.IntegratedGyroscope.X - RenderThreadSample.IntegratedGyroscope.X)};
+	const auto DeltaYaw{FMath::UnwindDegrees(Snapshot.IntegratedGyroscope.Y - RenderThreadSample.IntegratedGyroscope.Y)};
+
+	// The gyroscope follows the right-hand rule, so its positive yaw is a turn to the left, unlike the camera yaw.
+
+	const auto CorrectionPitch{FMath::Clamp(DeltaPitch * RenderThreadSample.PitchScale, -MaxCorrectionAngle, MaxCorrectionAngle)};
+	const auto CorrectionYaw{FMath::Clamp(-DeltaYaw * RenderThreadSample.YawScale, -MaxCorrectionAngle, MaxCorrectionAngle)};
+
+	View.ViewRotation.Pitch = FMath::Clamp(View.ViewRotation.Pitch + CorrectionPitch, -89.9, 89.9);
+	View.ViewRotation.Yaw += CorrectionYaw;
+
+	View.UpdateViewMatrix();
+}
+
+bool FDsGyroLateLatchingViewExtension::IsActiveThisFrame_Internal(const FSceneViewExtensionContext& Context) const
+{
+	return GetDefault<UDsSettings>()->bEnableGyroLateLatching;
+}
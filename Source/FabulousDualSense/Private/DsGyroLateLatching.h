@@ -0,0 +1,37 @@
+#pragma once
+
+#include "SceneViewExtension.h"
+
+class FABULOUSDUALSENSE_API FDsGyroLateLatchingViewExtension : public FSceneViewExtensionBase
+{
+private:
+	struct FSample
+	{
+		int32 ControllerId{INDEX_NONE};
+
+		uint64 SequenceNumber{0};
+
+		FVector3f IntegratedGyroscope{ForceInit};
+
+		float YawScale{0.0f};
+
+		float PitchScale{0.0f};
+	};
+
+	// The snapshot that the game thread used for the frame being rendered. Only accessed on the render thread.
+	FSample RenderThreadSample;
+
+public:
+	explicit FDsGyroLateLatchingViewExtension(const FAutoRegister& AutoRegister);
+
+	virtual void SetupViewFamily(FSceneViewFamily& ViewFamily) override;
+
+	virtual void SetupView(FSceneViewFamily& ViewFamily, FSceneView& View) override;
+
+	virtual void BeginRenderViewFamily(FSceneViewFamily& ViewFamily) override;
+
+	virtual void PreRenderView_RenderThread(FRDGBuilder& GraphBuilder, FSceneView& View) override;
+
+protected:
+	virtual bool IsActiveThisFrame_Internal(const FSceneViewExtensionContext& Context) const override;
+};
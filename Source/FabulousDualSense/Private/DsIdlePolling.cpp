@@ -0,0 +1,119 @@
+#include "DsIdlePolling.h"
+
+#include "DsConstants.h"
+#include "DsSettings.h"
+
+void FDsIdlePollingTracker::Reset(const double Time)
+{
+	*this = FDsIdlePollingTracker{};
+
+	LastActivityTime = Time;
+	LastUpdateTime = Time;
+}
+
+bool FDsIdlePollingTracker::IsIdle() const
+{
+	return Statistics.bIdle;
+}
+
+bool FDsIdlePollingTracker::ShouldPoll(const double Time, const UDsSettings& Settings)
+{
+	const auto DeltaTime{FMath::Max(0.0, Time - LastUpdateTime)};
+	LastUpdateTime = Time;
+
+	if (Statistics.bIdle)
+	{
+		Statistics.IdleTime += DeltaTime;
+
+		if (!Settings.bEnableIdlePolling)
+		{
+			Statistics.bIdle = false;
+			LastActivityTime = Time;
+		}
+		else if (Time < NextPollTime)
+		{
+			Statistics.SkippedPollsCount += 1;
+			Statistics.SavedCpuTime += AveragePollTime;
+			return false;
+		}
+		else
+		{
+			NextPollTime = Time + Settings.IdlePollingInterval;
+		}
+	}
+	else
+	{
+		Statistics.ActiveTime += DeltaTime;
+	}
+
+	Statistics.PollsCount += 1;
+	return true;
+}
+
+void FDsIdlePollingTracker::AddReport(const double Time, const DS5W::DS5InputState& PreviousInput, const DS5W::DS5InputState& NewInput)
+{
+	if (IsSignificantChange(PreviousInput, NewInput))
+	{
+		Statistics.bIdle = false;
+		LastActivityTime = Time;
+	}
+}
+
+void FDsIdlePollingTracker::FinishPoll(const double Time, const double PollTime, const DS5W::DS5InputState& Input,
+                                       const UDsSettings& Settings)
+{
+	if (Statistics.bIdle)
+	{
+		return;
+	}
+
+	AveragePollTime = AveragePollTime > 0.0 ? FMath::Lerp(AveragePollTime, PollTime, 0.05) : PollTime;
+
+	if (Settings.bEnableIdlePolling && Time - LastActivityTime >= Settings.IdleTimeout && IsUntouched(Input))
+	{
+		Statistics.bIdle = true;
+		NextPollTime = Time + Settings.IdlePollingInterval;
+	}
+}
+
+void FDsIdlePollingTracker::GetStatistics(FDsPollingStatistics& NewStatistics) const
+{
+	NewStatistics = Statistics;
+}
+
+bool FDsIdlePollingTracker::IsSignificantChange(const DS5W::DS5InputState& PreviousInput, const DS5W::DS5InputState& NewInput)
+{
+	// Small thresholds filter out the noise of analog inputs and motion sensors of a controller lying on a table.
+
+	static constexpr auto StickThreshold{8};
+	static constexpr auto TriggerThreshold{8};
+	static constexpr auto GyroscopeThreshold{DS_GYRO_RES_PER_DEG_S * 10};
+	static constexpr auto AccelerometerThreshold{DS_ACC_RES_PER_G / 10};
+
+	return PreviousInput.buttonMap != NewInput.buttonMap ||
+	       PreviousInput.touchPoint1.down != NewInput.touchPoint1.down ||
+	       PreviousInput.touchPoint2.down != NewInput.touchPoint2.down ||
+	       FMath::Abs(NewInput.leftStick.x - PreviousInput.leftStick.x) > StickThreshold ||
+	       FMath::Abs(NewInput.leftStick.y - PreviousInput.leftStick.y) > StickThreshold ||
+	       FMath::Abs(NewInput.rightStick.x - PreviousInput.rightStick.x) > StickThreshold ||
+	       FMath::Abs(NewInput.rightStick.y - PreviousInput.rightStick.y) > StickThreshold ||
+	       FMath::Abs(NewInput.leftTrigger - PreviousInput.leftTrigger) > TriggerThreshold ||
+	       FMath::Abs(NewInput.rightTrigger - PreviousInput.rightTrigger) > TriggerThreshold ||
+	       FMath::Abs(NewInput.gyroscope.x) > GyroscopeThreshold ||
+	       FMath::Abs(NewInput.gyroscope.y) > GyroscopeThreshold ||
+	       FMath::Abs(NewInput.gyroscope.z) > GyroscopeThreshold ||
+	       FMath::Abs(NewInput.accelerometer.x - PreviousInput.accelerometer.x) > AccelerometerThreshold ||
+	       FMath::Abs(NewInput.accelerometer.y - PreviousInput.accelerometer.y) > AccelerometerThreshold ||
+	       FMath::Abs(NewInput.accelerometer.z - PreviousInput.accelerometer.z) > AccelerometerThreshold;
+}
+
+bool FDsIdlePollingTracker::IsUntouched(const DS5W::DS5InputState& Input)
+{
+	return Input.buttonMap == 0 && !Input.touchPoint1.down && !Input.touchPoint2.down &&
+	       FMath::Abs(static_cast<int32>(Input.leftStick.x)) <= DsConstants::StickDeadZone &&
+	       FMath::Abs(static_cast<int32>(Input.leftStick.y)) <= DsConstants::StickDeadZone &&
+	       FMath::Abs(static_cast<int32>(Input.rightStick.x)) <= DsConstants::StickDeadZone &&
+	       FMath::Abs(static_cast<int32>(Input.rightStick.y)) <= DsConstants::StickDeadZone &&
+	       Input.leftTrigger <= DsConstants::TriggerDeadZone &&
+	       Input.rightTrigger <= DsConstants::TriggerDeadZone;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <DualSenseWindows.h>
+
+#include "DsStatistics.h"
+
+class UDsSettings;
+
+class FABULOUSDUALSENSE_API FDsIdlePollingTracker
+{
+private:
+	double LastActivityTime{0.0};
+
+	double LastUpdateTime{0.0};
+
+	double NextPollTime{0.0};
+
+	double AveragePollTime{0.0};
+
+	FDsPollingStatistics Statistics;
+
+public:
+	void Reset(double Time);
+
+	bool IsIdle() const;
+
+	// Returns false if the controller is idle and should not be polled during this frame.
+	bool ShouldPoll(double Time, const UDsSettings& Settings);
+
+	void AddReport(double Time, const DS5W::DS5InputState& PreviousInput, const DS5W::DS5InputState& NewInput);
+
+	void FinishPoll(double Time, double PollTime, const DS5W::DS5InputState& Input, const UDsSettings& Settings);
+
+	void GetStatistics(FDsPollingStatistics& NewStatistics) const;
+
+private:
+	static bool IsSignificantChange(const DS5W::DS5InputState& PreviousInput, const DS5W::DS5InputState& NewInput);
+
+	static bool IsUntouched(const DS5W::DS5InputState& Input);
+};
@@ -0,0 +1,177 @@
+#include "DsImuCalibration.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#endif
+
+void FDsImuCalibration::Compile(const DS5W::DeviceCalibrationData& CalibrationData)
+{
+	*this = FDsImuCalibration{};
+
+	const DS5W::AxisCalibrationData* Axes[AxesCount]{
+		&CalibrationData.gyroscope[0], &CalibrationData.gyroscope[1], &CalibrationData.gyroscope[2],
+		&CalibrationData.accelerometer[0], &CalibrationData.accelerometer[1], &CalibrationData.accelerometer[2]
+	};
+
+	// Unused lanes divide by one, which keeps the multipliers valid.
+
+	uint32 AbsoluteDenominators[LanesCount]{1, 1, 1, 1, 1, 1, 1, 1};
+	int32 DenominatorBits[LanesCount]{};
+
+	for (auto i{0}; i < AxesCount; i++)
+	{
+		const auto& Axis{*Axes[i]};
+
+		Bias[i] = Axis.bias;
+		Scale[i] = i < 3 ? 1.0f / DS_GYRO_RES_PER_DEG_S : 1.0f / DS_ACC_RES_PER_G;
+
+		if (Axis.sens_denom == 0)
+		{
+			// Invalid calibration data, so the axis always stays at zero instead of crashing on the division by zero.
+			continue;
+		}
+
+		Quotient[i] = Axis.sens_numer / Axis.sens_denom;
+		Remainder[i] = Axis.sens_numer % Axis.sens_denom;
+
+		DenominatorSignMask[i] = Axis.sens_denom < 0 ? -1 : 0;
+
+		AbsoluteDenominators[i] = Axis.sens_denom < 0
+			                          ? 0u - static_cast<uint32>(Axis.sens_denom)
+			                          : static_cast<uint32>(Axis.sens_denom);
+
+		// Number of bits required to represent the denominator, rounded up.
+		DenominatorBits[i] = AbsoluteDenominators[i] <= 1 ? 0 : 32 - FMath::CountLeadingZeros(AbsoluteDenominators[i] - 1);
+
+		Shift = FMath::Max(Shift, DenominatorBits[i]);
+	}
+
+	for (auto i{0}; i < LanesCount; i++)
+	{
+		// The multiplier is floor(2^(32 + N) / D) + 1, which gives the exact quotient for any 32-bit dividend. It is
+		// then scaled to the largest shift among all axes so that a single shift can be used for all of them.
+
+		const auto Multiplier{
+			((1ull << (32 + DenominatorBits[i])) / AbsoluteDenominators[i] + 1) << (Shift - DenominatorBits[i])
+		};
+
+		MultiplierHigh[i] = static_cast<uint32>(Multiplier >> 32);
+		MultiplierLow[i] = static_cast<uint32>(Multiplier);
+	}
+}
+
+#if PLATFORM_CPU_X86_FAMILY
+namespace DsImuCalibration
+{
+	// SSE2 has no 32-bit multiplication, so emulate it with two 32 x 32 -> 64 bit multiplications.
+
+	__m128i MultiplyLow(const __m128i A, const __m128i B)
+	{
+		const auto Even{_mm_mul_epu32(A, B)};
+		const auto Odd{_mm_mul_epu32(_mm_srli_epi64(A, 32), _mm_srli_epi64(B, 32))};
+
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(Even, _MM_SHUFFLE(0, 0, 2, 0)),
+		                          _mm_shuffle_epi32(Odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	}
+
+	__m128i DivideUnsigned(const __m128i Dividend, const __m128i MultiplierHigh, const __m128i MultiplierLow, const __m128i Shift)
+	{
+		// Calculates (Multiplier * Dividend) >> (32 + Shift) for the even and odd lanes separately. The
+		// quotients are less than 2^31, so the upper halves of the 64-bit results are always zero.
+
+		const auto Even{
+			_mm_srl_epi64(_mm_add_epi64(_mm_mul_epu32(MultiplierHigh, Dividend),
+			                            _mm_srli_epi64(_mm_mul_epu32(MultiplierLow, Dividend), 32)), Shift)
+		};
+
+		const auto OddDividend{_mm_srli_epi64(Dividend, 32)};
+
+		const auto Odd{
+			_mm_srl_epi64(_mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(MultiplierHigh, 32), OddDividend),
+			                            _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(MultiplierLow, 32), OddDividend), 32)), Shift)
+		};
+
+		return _mm_or_si128(Even, _mm_slli_epi64(Odd, 32));
+	}
+}
+#endif
+
+void FDsImuCalibration::Calibrate(const int16 (&RawValues)[AxesCount], int32 (&CalibratedValues)[AxesCount],
+                                  float (&PhysicalValues)[AxesCount]) const
+{
+#if PLATFORM_CPU_X86_FAMILY
+	alignas(16) int32 Values[LanesCount]{RawValues[0], RawValues[1], RawValues[2], RawValues[3], RawValues[4], RawValues[5]};
+	alignas(16) float Floats[LanesCount];
+
+	const auto ShiftRegister{_mm_cvtsi32_si128(Shift)};
+
+	for (auto i{0}; i < LanesCount; i += 4)
+	{
+		const auto Value{
+			_mm_sub_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(&Values[i])),
+			              _mm_load_si128(reinterpret_cast<const __m128i*>(&Bias[i])))
+		};
+
+		const auto QuotientPart{DsImuCalibration::MultiplyLow(_mm_load_si128(reinterpret_cast<const __m128i*>(&Quotient[i])), Value)};
+		const auto Product{DsImuCalibration::MultiplyLow(_mm_load_si128(reinterpret_cast<const __m128i*>(&Remainder[i])), Value)};
+
+		// Divide the absolute value of the product and then restore the sign, which matches the truncating signed division.
+
+		const auto ProductSignMask{_mm_srai_epi32(Product, 31)};
+		const auto AbsoluteProduct{_mm_sub_epi32(_mm_xor_si128(Product, ProductSignMask), ProductSignMask)};
+
+		const auto AbsoluteRemainderPart{
+			DsImuCalibration::DivideUnsigned(AbsoluteProduct,
+			                                 _mm_load_si128(reinterpret_cast<const __m128i*>(&MultiplierHigh[i])),
+			                                 _mm_load_si128(reinterpret_cast<const __m128i*>(&MultiplierLow[i])),
+			                                 ShiftRegister)
+		};
+
+		const auto RemainderPartSignMask{
+			_mm_xor_si128(ProductSignMask, _mm_load_si128(reinterpret_cast<const __m128i*>(&DenominatorSignMask[i])))
+		};
+
+		const auto Result{
+			_mm_add_epi32(QuotientPart, _mm_sub_epi32(_mm_xor_si128(AbsoluteRemainderPart, RemainderPartSignMask), RemainderPartSignMask))
+		};
+
+		_mm_store_si128(reinterpret_cast<__m128i*>(&Values[i]), Result);
+		_mm_store_ps(&Floats[i], _mm_mul_ps(_mm_cvtepi32_ps(Result), _mm_load_ps(&Scale[i])));
+	}
+
+	for (auto i{0}; i < AxesCount; i++)
+	{
+		CalibratedValues[i] = Values[i];
+		PhysicalValues[i] = Floats[i];
+	}
+#else
+	CalibrateScalar(RawValues, CalibratedValues, PhysicalValues);
+#endif
+}
+
+void FDsImuCalibration::CalibrateScalar(const int16 (&RawValues)[AxesCount], int32 (&CalibratedValues)[AxesCount],
+                                        float (&PhysicalValues)[AxesCount]) const
+{
+	// Unsigned arithmetic is used to get the same wraparound behavior as the SIMD version.
+
+	for (auto i{0}; i < AxesCount; i++)
+	{
+		const auto Value{static_cast<uint32>(RawValues[i] - Bias[i])};
+
+		const auto QuotientPart{static_cast<uint32>(Quotient[i]) * Value};
+		const auto Product{static_cast<uint32>(Remainder[i]) * Value};
+
+		const auto ProductSignMask{static_cast<uint32>(static_cast<int32>(Product) >> 31)};
+		const auto AbsoluteProduct{(Product ^ ProductSignMask) - ProductSignMask};
+
+		const auto AbsoluteRemainderPart{
+			static_cast<uint32>((static_cast<uint64>(MultiplierHigh[i]) * AbsoluteProduct +
+			                     (static_cast<uint64>(MultiplierLow[i]) * AbsoluteProduct >> 32)) >> Shift)
+		};
+
+		const auto RemainderPartSignMask{ProductSignMask ^ static_cast<uint32>(DenominatorSignMask[i])};
+
+		CalibratedValues[i] = static_cast<int32>(QuotientPart + ((AbsoluteRemainderPart ^ RemainderPartSignMask) - RemainderPartSignMask));
+		PhysicalValues[i] = static_cast<float>(CalibratedValues[i]) * Scale[i];
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <DualSenseWindows.h>
+
+struct FABULOUSDUALSENSE_API FDsMotionState
+{
+	// Degrees per second.
+	FVector3f Gyroscope{ForceInit};
+
+	// Multiples of the standard gravity.
+	FVector3f Accelerometer{ForceInit};
+
+	// Low-pass filtered accelerometer, multiples of the standard gravity.
+	FVector3f Gravity{ForceInit};
+
+	// Gyroscope integrated over the sensor time, in degrees wrapped to the [-180, 180] range.
+	FVector3f IntegratedGyroscope{ForceInit};
+
+	uint8 bHasGravity : 1 {false};
+};
+
+// Motion sensors calibration data precompiled into multiply-shift coefficients, which allows calibrating all axes
+// in a single SIMD pass without integer divisions, while producing exactly the same results as mult_frac() for
+// all calibration data and raw values that don't overflow it.
+struct FABULOUSDUALSENSE_API FDsImuCalibration
+{
+	// Gyroscope X, Y, Z followed by accelerometer X, Y, Z, in the same order as in the input report.
+	static constexpr auto AxesCount{6};
+
+	// The number of axes rounded up to a multiple of the SIMD register width.
+	static constexpr auto LanesCount{8};
+
+	alignas(16) int32 Bias[LanesCount]{};
+
+	// mult_frac() splits the multiplication by a fraction into the multiplication by
+	// the quotient and the division of the multiplied remainder by the denominator.
+
+	alignas(16) int32 Quotient[LanesCount]{};
+	alignas(16) int32 Remainder[LanesCount]{};
+
+	// -1 for negative denominators, 0 otherwise.
+	alignas(16) int32 DenominatorSignMask[LanesCount]{};
+
+	// High and low 32 bits of the multiplier that replaces the division by the absolute value of the denominator.
+
+	alignas(16) uint32 MultiplierHigh[LanesCount]{};
+	alignas(16) uint32 MultiplierLow[LanesCount]{};
+
+	// Converts calibrated values to degrees per second and multiples of the standard gravity.
+	alignas(16) float Scale[LanesCount]{};
+
+	int32 Shift{0};
+
+	void Compile(const DS5W::DeviceCalibrationData& CalibrationData);
+
+	void Calibrate(const int16 (&RawValues)[AxesCount], int32 (&CalibratedValues)[AxesCount], float (&PhysicalValues)[AxesCount]) const;
+
+	// Same as FDsImuCalibration::Calibrate(), but without SIMD.
+	void CalibrateScalar(const int16 (&RawValues)[AxesCount], int32 (&CalibratedValues)[AxesCount], float (&PhysicalValues)[AxesCount]) const;
+};
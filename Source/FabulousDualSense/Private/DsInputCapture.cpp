@@ -0,0 +1,178 @@
+#include "DsInputCapture.h"
+
+#include "DsUtility.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace DsInputCapture
+{
+	static constexpr uint32 FileMagic{0x43495344}; // "DSIC".
+
+	static constexpr uint32 FileVersion{1};
+}
+
+void FDsInputCapture::AddReport(const double Time, const TConstArrayView<uint8> Data)
+{
+	if (StartTime < 0.0)
+	{
+		StartTime = Time;
+	}
+
+	Reports.Add({
+		.Time = Time - StartTime,
+		.DataOffset = ReportsData.Num(),
+		.DataSize = FMath::Min(Data.Num(), static_cast<int32>(DS_MAX_INPUT_REPORT_SIZE))
+	});
+
+	ReportsData.Append(Data.GetData(), Reports.Last().DataSize);
+}
+
+int32 FDsInputCapture::GetReportsCount() const
+{
+	return Reports.Num();
+}
+
+const FDsInputCapture::FReport& FDsInputCapture::GetReport(const int32 Index) const
+{
+	return Reports[Index];
+}
+
+TConstArrayView<uint8> FDsInputCapture::GetReportData(const int32 Index) const
+{
+	const auto& Report{Reports[Index]};
+
+	return {ReportsData.GetData() + Report.DataOffset, Report.DataSize};
+}
+
+double FDsInputCapture::GetDuration() const
+{
+	return Reports.Num() > 0 ? Reports.Last().Time : 0.0;
+}
+
+bool FDsInputCapture::LoadFromFile(const FString& FilePath)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *FilePath))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader{Data};
+
+	Serialize(Reader);
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogFabulousDualSense, Warning, TEXT("Input capture is outdated or corrupted: %s."), *FilePath);
+
+		Reports.Reset();
+		ReportsData.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+bool FDsInputCapture::SaveToFile(const FString& FilePath)
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer{Data};
+
+	Serialize(Writer);
+
+	return FFileHelper::SaveArrayToFile(Data, *FilePath);
+}
+
+void FDsInputCapture::Serialize(FArchive& Archive)
+{
+	auto Magic{DsInputCapture::FileMagic};
+	auto Version{DsInputCapture::FileVersion};
+
+	Archive << Magic << Version;
+
+	if (Magic != DsInputCapture::FileMagic || Version != DsInputCapture::FileVersion)
+	{
+		Archive.SetError();
+		return;
+	}
+
+	auto ModelValue{static_cast<uint8>(Model)};
+	auto ConnectionValue{static_cast<uint8>(Connection)};
+
+	Archive << ModelValue << ConnectionValue;
+
+	if (ModelValue > static_cast<uint8>(EDsDeviceModel::DualShock4) ||
+	    (ConnectionValue != static_cast<uint8>(DS5W::DeviceConnection::USB) &&
+	     ConnectionValue != static_cast<uint8>(DS5W::DeviceConnection::BT)))
+	{
+		Archive.SetError();
+		return;
+	}
+
+	Model = static_cast<EDsDeviceModel>(ModelValue);
+	Connection = static_cast<DS5W::DeviceConnection>(ConnectionValue);
+
+	auto ReportsCount{Reports.Num()};
+
+	Archive << ReportsCount;
+
+	if (Archive.IsLoading())
+	{
+		if (ReportsCount < 0)
+		{
+			Archive.SetError();
+			return;
+		}
+
+		Reports.SetNum(ReportsCount);
+	}
+
+	for (auto& Report : Reports)
+	{
+		Archive << Report.Time << Report.DataOffset << Report.DataSize;
+	}
+
+	Archive << ReportsData;
+
+	if (Archive.IsLoading())
+	{
+		for (const auto& Report : Reports)
+		{
+			if (Report.DataOffset < 0 || Report.DataSize < 0 || Report.DataSize > DS_MAX_INPUT_REPORT_SIZE ||
+			    Report.DataOffset + Report.DataSize > ReportsData.Num())
+			{
+				Archive.SetError();
+				return;
+			}
+		}
+	}
+}
+
+FDsInputCaptureRecorder::FDsInputCaptureRecorder(const int32 ControllerId, const FDsDeviceModelBinding& Binding)
+	: ControllerId{ControllerId}
+{
+	Capture.Model = Binding.Model;
+	Capture.Connection = Binding.Connection;
+}
+
+int32 FDsInputCaptureRecorder::GetControllerId() const
+{
+	return ControllerId;
+}
+
+uint64 FDsInputCaptureRecorder::GetMissedReportsCount() const
+{
+	return MissedReportsCount;
+}
+
+void FDsInputCaptureRecorder::Update()
+{
+	MissedReportsCount += Reader.Read([this](const FDsRawReport& Report)
+	{
+		if (Report.ControllerId == ControllerId)
+		{
+			Capture.AddReport(Report.Time, Report.Data);
+		}
+	});
+}
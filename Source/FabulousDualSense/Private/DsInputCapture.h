@@ -0,0 +1,117 @@
+#pragma once
+
+#include <DualSenseWindows.h>
+
+#include "DsDeviceModels.h"
+#include "DsRawReports.h"
+
+// Raw input reports of a single controller, as read by the input device, stored on disk so that they
+// can be replayed later through a simulated device, for example to benchmark the input path without hardware.
+class FABULOUSDUALSENSE_API FDsInputCapture
+{
+public:
+	struct FReport
+	{
+		// Seconds since the first report of the capture. Reports read during the same frame share the same time.
+		double Time{0.0};
+
+		int32 DataOffset{0};
+
+		int32 DataSize{0};
+	};
+
+public:
+	EDsDeviceModel Model{EDsDeviceModel::DualSense};
+
+	DS5W::DeviceConnection Connection{DS5W::DeviceConnection::USB};
+
+private:
+	TArray<FReport> Reports;
+
+	// The data of all reports, stored contiguously.
+	TArray<uint8> ReportsData;
+
+	double StartTime{-1.0};
+
+public:
+	void AddReport(double Time, TConstArrayView<uint8> Data);
+
+	int32 GetReportsCount() const;
+
+	const FReport& GetReport(int32 Index) const;
+
+	TConstArrayView<uint8> GetReportData(int32 Index) const;
+
+	// The time of the last report, relative to the first one.
+	double GetDuration() const;
+
+	bool LoadFromFile(const FString& FilePath);
+
+	bool SaveToFile(const FString& FilePath);
+
+private:
+	void Serialize(FArchive& Archive);
+};
+
+// Records the reports of one controller from the shared ring buffer of raw input reports. Must only be used on the game thread.
+class FABULOUSDUALSENSE_API FDsInputCaptureRecorder
+{
+private:
+	FDsRawReportReader Reader;
+
+	int32 ControllerId{INDEX_NONE};
+
+	uint64 MissedReportsCount{0};
+
+public:
+	FDsInputCapture Capture;
+
+public:
+	FDsInputCaptureRecorder(int32 ControllerId, const FDsDeviceModelBinding& Binding);
+
+	int32 GetControllerId() const;
+
+	// Reports missed because the recorder was updated too rarely, including the ones of other controllers.
+	uint64 GetMissedReportsCount() const;
+
+	// Must be called at least once per frame, otherwise reports may be missed.
+	void Update();
+};
+
+struct FABULOUSDUALSENSE_API FDsReplayOptions
+{
+	// If enabled, frames are paced by the wall clock, otherwise they are processed as fast as possible.
+	bool bRealTime{false};
+
+	int32 LoopsCount{1};
+
+	// Reports are grouped into frames by their capture time, as if the game was running at this frame rate.
+	float FrameRate{60.0f};
+};
+
+struct FABULOUSDUALSENSE_API FDsReplayResults
+{
+	int32 FramesCount{0};
+
+	int64 ReportsCount{0};
+
+	int64 AnalogEventsCount{0};
+
+	int64 ButtonEventsCount{0};
+
+	int64 MouseEventsCount{0};
+
+	int64 AllocationsCount{0};
+
+	// Wall time of the measured frames, including the waiting between frames when replaying in real time.
+	double ElapsedTime{0.0};
+
+	// Reading, validating, decoding and filtering the input reports.
+	double ReportProcessingTime{0.0};
+
+	// Comparing the input states and sending the input events.
+	double EventDispatchTime{0.0};
+
+	// Writing the output state, which is a no-op for the simulated device apart from the state tracking.
+	double OutputTime{0.0};
+};
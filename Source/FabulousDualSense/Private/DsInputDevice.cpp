@@ -1,52 +1,195 @@
 #include "DsInputDevice.h"
 
+#include "DsAllocationCounter.h"
+#include "DsBenchmark.h"
+#include "DsDeviceProperties.h"
+#include "DsInputSnapshotPublisher.h"
+#include "DsKeys.h"
+#include "DsRawReportsPublisher.h"
+#include "DsReport.h"
 #include "DsSettings.h"
 #include "DsUtility.h"
+#include "SDsDiagnosticsPanel.h"
+#include "Async/ParallelFor.h"
 #include "Containers/StaticBitArray.h"
 #include "Framework/Application/SlateApplication.h"
 #include "GameFramework/InputSettings.h"
 #include "GenericPlatform/IInputInterface.h"
 #include "Misc/ConfigCacheIni.h"
 #include "Misc/EnumerateRange.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
 
-FDsInputDevice::FDsInputDevice(const TSharedRef<FGenericApplicationMessageHandler>& MessageHandler) : MessageHandler{MessageHandler}
+#include "Windows/AllowWindowsPlatformTypes.h"
+
+#include <hidsdi.h>
+
+#include "Windows/HideWindowsPlatformTypes.h"
+
+namespace DsInputDevice
+{
+	// Counts input events instead of passing them to the game.
+	class FEventsCounter final : public FGenericApplicationMessageHandler
+	{
+	public:
+		int64 AnalogEventsCount{0};
+
+		int64 ButtonEventsCount{0};
+
+		int64 MouseEventsCount{0};
+
+	public:
+		virtual bool OnControllerAnalog(FGamepadKeyNames::Type KeyName, FPlatformUserId PlatformUserId,
+		                                FInputDeviceId InputDeviceId, float AnalogValue) override
+		{
+			AnalogEventsCount += 1;
+			return false;
+		}
+
+		virtual bool OnControllerButtonPressed(FGamepadKeyNames::Type KeyName, FPlatformUserId PlatformUserId,
+		                                       FInputDeviceId InputDeviceId, bool IsRepeat) override
+		{
+			ButtonEventsCount += 1;
+			return false;
+		}
+
+		virtual bool OnControllerButtonReleased(FGamepadKeyNames::Type KeyName, FPlatformUserId PlatformUserId,
+		                                        FInputDeviceId InputDeviceId, bool IsRepeat) override
+		{
+			ButtonEventsCount += 1;
+			return false;
+		}
+
+		virtual bool OnRawMouseMove(int32 X, int32 Y) override
+		{
+			MouseEventsCount += 1;
+			return false;
+		}
+	};
+
+	FTimespan GetRemainingTime(const double Deadline)
+	{
+		return FTimespan::FromSeconds(FMath::Max(0.0, Deadline - FPlatformTime::Seconds()));
+	}
+
+	int32 SetUpInputBuffers(const DS5W::DeviceContext& Context)
+	{
+		// The OS keeps only 32 input reports by default, which a hitch of a few dozen milliseconds is enough to overflow.
+		// Not more than a single frame can read, otherwise the reports piled up during a hitch would delay the input.
+
+		static constexpr ::ULONG DefaultInputBuffersCount{32};
+
+		HidD_SetNumInputBuffers(Context._internal.deviceHandle, DsConstants::MaxInputReportsPerFrame);
+
+		::ULONG ActualInputBuffersCount{0};
+		if (!HidD_GetNumInputBuffers(Context._internal.deviceHandle, &ActualInputBuffersCount))
+		{
+			ActualInputBuffersCount = DefaultInputBuffersCount;
+		}
+
+		return static_cast<int32>(ActualInputBuffersCount);
+	}
+
+	void CancelInputRequest(DS5W::DeviceContext& Context)
+	{
+		// The cancellation is asynchronous, the request still owns the input buffer until its completion is reported.
+
+		CancelIoEx(Context._internal.deviceHandle, &Context._internal.olRead);
+
+		::DWORD BytesTransferred{0};
+		GetOverlappedResult(Context._internal.deviceHandle, &Context._internal.olRead, &BytesTransferred, true);
+	}
+}
+
+FDsInputDevice::FDsInputDevice(const TSharedRef<FGenericApplicationMessageHandler>& MessageHandler, const bool bDiscoverDevices)
+	: MessageHandler{MessageHandler}, bDiscoverDevices{bDiscoverDevices}
 {
 	GConfig->GetFloat(TEXT("/Script/Engine.InputSettings"), TEXT("InitialButtonRepeatDelay"), InitialButtonRepeatDelay, GInputIni);
 	GConfig->GetFloat(TEXT("/Script/Engine.InputSettings"), TEXT("ButtonRepeatDelay"), ButtonRepeatDelay, GInputIni);
 
-	RefreshDevices();
+	ShutdownTimeBudget = GetDefault<UDsSettings>()->ShutdownTimeBudget;
+
+	if (bDiscoverDevices)
+	{
+		StartStartupDiscovery();
+	}
 }
 
 FDsInputDevice::~FDsInputDevice()
 {
-	auto& InputDeviceMapper{IPlatformInputDeviceMapper::Get()};
+	const auto ShutdownDeadline{FPlatformTime::Seconds() + ShutdownTimeBudget};
 
-	for (const auto DeviceContext : EnumerateRange(DeviceContexts))
+	if (StartupDiscoveryTask.IsValid())
 	{
-		if (DeviceContext->_internal.connected)
-		{
-			auto PlatformUserId{PLATFORMUSERID_NONE};
-			auto InputDeviceId{INPUTDEVICEID_NONE};
-			InputDeviceMapper.RemapControllerIdToPlatformUserAndDevice(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId);
+		// The discovery finished after the last tick, so the devices it initialized were never connected. If it's still
+		// running, it's abandoned along with its shared state, and the devices it initializes are never freed.
 
-			DisconnectDevice(InputDeviceMapper, DeviceContext.GetIndex(), PlatformUserId, InputDeviceId);
+		if (StartupDiscoveryTask.Wait(DsInputDevice::GetRemainingTime(ShutdownDeadline)))
+		{
+			for (auto i{0}; i < StartupDiscovery->DevicesCount; i++)
+			{
+				if (DS5W_SUCCESS(StartupDiscovery->DeviceResults[i]))
+				{
+					freeDeviceContext(&StartupDiscovery->DeviceContexts[i]);
+				}
+			}
+		}
+		else
+		{
+			UE_LOG(LogFabulousDualSense, Warning, TEXT("Startup device discovery didn't finish within %.3f seconds, abandoning it."),
+			       ShutdownTimeBudget);
 		}
 	}
+
+	ReleaseAllDevices(ShutdownDeadline);
 }
 
 void FDsInputDevice::Tick(float DeltaTime)
 {
-	RefreshDevices();
+	if (CaptureRecorder.IsValid())
+	{
+		CaptureRecorder->Update();
+	}
+
+	if (StartupDiscoveryTask.IsValid())
+	{
+		if (!StartupDiscoveryTask.IsCompleted())
+		{
+			// The devices that the startup discovery is opening must not be opened again.
+			return;
+		}
+
+		CompleteStartupDiscovery();
+	}
+
+	if (bDiscoverDevices)
+	{
+		RefreshDevices();
+	}
+
+	CalibrationCache.Update();
 }
 
 void FDsInputDevice::SendControllerEvents()
 {
-	const auto Time{FPlatformTime::Seconds()};
+	ProcessControllerEvents(FPlatformTime::Seconds(), GetAnalogSendMode(*GetDefault<UDsSettings>()));
+}
+
+void FDsInputDevice::ProcessControllerEvents(const double Time, const EDsAnalogSendMode AnalogSendMode)
+{
+	const auto& Settings{*GetDefault<UDsSettings>()};
 
 	auto& InputDeviceMapper{IPlatformInputDeviceMapper::Get()};
 
 	for (const auto DeviceContext : EnumerateRange(DeviceContexts))
 	{
+		if (ReconnectionTrackers[DeviceContext.GetIndex()].IsReconnecting())
+		{
+			UpdateReconnection(InputDeviceMapper, DeviceContext.GetIndex(), Time, Settings);
+			continue;
+		}
+
 		if (!DeviceContext->_internal.connected)
 		{
 			continue;
@@ -58,128 +201,186 @@ void FDsInputDevice::SendControllerEvents()
 
 		auto PlatformUserId{PLATFORMUSERID_NONE};
 		auto InputDeviceId{INPUTDEVICEID_NONE};
-		InputDeviceMapper.RemapControllerIdToPlatformUserAndDevice(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId);
+		RemapControllerId(InputDeviceMapper, DeviceContext.GetIndex(), PlatformUserId, InputDeviceId);
+
+		auto& IdlePolling{IdlePollingTrackers[DeviceContext.GetIndex()]};
+
+		if (!IdlePolling.ShouldPoll(Time, Settings))
+		{
+			WriteOutputState(InputDeviceMapper, DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, Time);
+			continue;
+		}
+
+		const auto PollStartCycles{FPlatformTime::Cycles64()};
+
+		if (IdlePolling.IsIdle())
+		{
+			// The reports received since the previous poll have most likely overflowed the system input buffer.
+
+			LinkQualityTrackers[DeviceContext.GetIndex()].Resynchronize();
+		}
 
 		const auto PreviousInput{InputStates[DeviceContext.GetIndex()]};
 
 		auto& Context{DeviceContexts[DeviceContext.GetIndex()]};
 		auto& Input{InputStates[DeviceContext.GetIndex()]};
-		auto& Output{OutputStates[DeviceContext.GetIndex()]};
 
-		const auto ReadInputResult{getDeviceInputState(&Context, &Input)};
+		const auto ReadInputResult{ReadInputReports(DeviceContext.GetIndex(), Time)};
 		if (DS5W_FAILED(ReadInputResult))
 		{
 			UE_LOG(LogFabulousDualSense, Warning, TEXT("Failed to read device input state: %s, Device: %s."),
 			       DsUtility::ReturnValueToString(ReadInputResult).GetData(), Context._internal.devicePath);
 
-			DisconnectDevice(InputDeviceMapper, DeviceContext.GetIndex(), PlatformUserId, InputDeviceId);
+			IoTrackers[DeviceContext.GetIndex()].AddFailedRead();
+
+			HandleConnectionLost(InputDeviceMapper, DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, Time);
 			continue;
 		}
 
-		// Sticks.
+		auto StageStartCycles{PollStartCycles};
+		AccumulateStageCycles(&FDsStageCycles::ReportProcessing, StageStartCycles);
+
+		double ReportAge;
+		if (InputPredictors[DeviceContext.GetIndex()].GetLatestSampleAge(Time, ReportAge))
+		{
+			IoTrackers[DeviceContext.GetIndex()].AddReportAge(ReportAge);
+		}
 
-		ProcessStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftAnalogX, PreviousInput.leftStick.x, Input.leftStick.x);
-		ProcessStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftAnalogY, PreviousInput.leftStick.y, Input.leftStick.y);
+		auto& Extra{ExtraStates[DeviceContext.GetIndex()]};
 
-		ProcessStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::RightAnalogX, PreviousInput.rightStick.x, Input.rightStick.x);
-		ProcessStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::RightAnalogY, PreviousInput.rightStick.y, Input.rightStick.y);
+		auto FrameAnalogSendMode{AnalogSendMode};
 
-		// Triggers.
+		if (AnalogSendMode == EDsAnalogSendMode::OnChange && Time >= Extra.NextAnalogKeepAliveTime)
+		{
+			FrameAnalogSendMode = EDsAnalogSendMode::OnChangeWithKeepAlive;
+			Extra.NextAnalogKeepAliveTime = Time + Settings.AnalogKeepAliveInterval;
+		}
 
-		if (PreviousInput.leftTrigger != Input.leftTrigger || Input.leftTrigger > DsConstants::TriggerDeadZone)
+		// Corrections from the smoothing and the prediction, added to the latest values.
+
+		float Corrections[FDsInputPredictor::AxesCount]{};
+
+		if (Settings.bEnableGyroSmoothing || Settings.bEnableStickSmoothing)
 		{
-			MessageHandler->OnControllerAnalog(FGamepadKeyNames::LeftTriggerAnalog, PlatformUserId, InputDeviceId,
-			                                   Input.leftTrigger / static_cast<float>(TNumericLimits<uint8>::Max()));
+			InputSmoothers[DeviceContext.GetIndex()].GetDeltas(Input, Settings, Corrections);
 		}
 
-		if (PreviousInput.rightTrigger != Input.rightTrigger || Input.rightTrigger > DsConstants::TriggerDeadZone)
+		if (Settings.bEnableInputPrediction)
 		{
-			MessageHandler->OnControllerAnalog(FGamepadKeyNames::RightTriggerAnalog, PlatformUserId, InputDeviceId,
-			                                   Input.rightTrigger / static_cast<float>(TNumericLimits<uint8>::Max()));
+			float PredictionDeltas[FDsInputPredictor::AxesCount];
+			InputPredictors[DeviceContext.GetIndex()].Predict(Time, Settings, PredictionDeltas);
+
+			for (auto i{0}; i < FDsInputPredictor::AxesCount; i++)
+			{
+				Corrections[i] += PredictionDeltas[i];
+			}
 		}
 
-		// Gyroscope.
+		// Sticks.
+
+		ProcessStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftAnalogX, PreviousInput.leftStick.x, Input.leftStick.x,
+		             Corrections[FDsInputPredictor::LeftStickX], Extra.SentLeftStick.X, FrameAnalogSendMode, Settings);
+		ProcessStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftAnalogY, PreviousInput.leftStick.y, Input.leftStick.y,
+		             Corrections[FDsInputPredictor::LeftStickY], Extra.SentLeftStick.Y, FrameAnalogSendMode, Settings);
+
+		ProcessStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::RightAnalogX, PreviousInput.rightStick.x, Input.rightStick.x,
+		             Corrections[FDsInputPredictor::RightStickX], Extra.SentRightStick.X, FrameAnalogSendMode, Settings);
+		ProcessStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::RightAnalogY, PreviousInput.rightStick.y, Input.rightStick.y,
+		             Corrections[FDsInputPredictor::RightStickY], Extra.SentRightStick.Y, FrameAnalogSendMode, Settings);
+
+		// Triggers.
+
+		ProcessTrigger(PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftTriggerAnalog, PreviousInput.leftTrigger,
+		               Input.leftTrigger, Extra.SentLeftTrigger, FrameAnalogSendMode, Settings);
+		ProcessTrigger(PlatformUserId, InputDeviceId, FGamepadKeyNames::RightTriggerAnalog, PreviousInput.rightTrigger,
+		               Input.rightTrigger, Extra.SentRightTrigger, FrameAnalogSendMode, Settings);
+
+		// Gyroscope. Corrected values are sent on every frame, since they change even without new reports.
 
-		if (PreviousInput.gyroscope.x != Input.gyroscope.x)
+		const auto bGyroscopeCorrected{
+			Corrections[FDsInputPredictor::GyroscopeX] != 0.0f ||
+			Corrections[FDsInputPredictor::GyroscopeY] != 0.0f ||
+			Corrections[FDsInputPredictor::GyroscopeZ] != 0.0f
+		};
+
+		const auto bSendGyroscope{bGyroscopeCorrected || Extra.bGyroscopeCorrected};
+
+		Extra.bGyroscopeCorrected = bGyroscopeCorrected;
+
+		if (bSendGyroscope || PreviousInput.gyroscope.x != Input.gyroscope.x)
 		{
 			// Gyroscope X represents Unreal Engine's pitch axis.
 
-			MessageHandler->OnControllerAnalog(DsConstants::GyroscopeAxisPitchKey.GetFName(),
-			                                   PlatformUserId, InputDeviceId, Input.gyroscope.x * 0.0001f);
+			MessageHandler->OnControllerAnalog(DsConstants::GyroscopeAxisPitchKey.GetFName(), PlatformUserId, InputDeviceId,
+			                                   (Input.gyroscope.x + Corrections[FDsInputPredictor::GyroscopeX]) * 0.0001f);
 		}
 
-		if (PreviousInput.gyroscope.y != Input.gyroscope.y)
+		if (bSendGyroscope || PreviousInput.gyroscope.y != Input.gyroscope.y)
 		{
 			// Gyroscope Y represents Unreal Engine's yaw axis.
 
-			MessageHandler->OnControllerAnalog(DsConstants::GyroscopeAxisYawKey.GetFName(),
-			                                   PlatformUserId, InputDeviceId, Input.gyroscope.y * 0.0001f);
+			MessageHandler->OnControllerAnalog(DsConstants::GyroscopeAxisYawKey.GetFName(), PlatformUserId, InputDeviceId,
+			                                   (Input.gyroscope.y + Corrections[FDsInputPredictor::GyroscopeY]) * 0.0001f);
 		}
 
-		if (PreviousInput.gyroscope.z != Input.gyroscope.z)
+		if (bSendGyroscope || PreviousInput.gyroscope.z != Input.gyroscope.z)
 		{
 			// Gyroscope Z represents Unreal Engine's roll axis.
 
-			MessageHandler->OnControllerAnalog(DsConstants::GyroscopeAxisRollKey.GetFName(),
-			                                   PlatformUserId, InputDeviceId, Input.gyroscope.z * 0.0001f);
+			MessageHandler->OnControllerAnalog(DsConstants::GyroscopeAxisRollKey.GetFName(), PlatformUserId, InputDeviceId,
+			                                   (Input.gyroscope.z + Corrections[FDsInputPredictor::GyroscopeZ]) * 0.0001f);
 		}
 
-		// Regular buttons.
+		// Gyro aim. The rotation is accumulated on every report, but sent only once per frame.
 
-		auto ButtonIndex{0};
-
-		for (const auto& [ButtonName, ButtonFlag] : DsConstants::GetRegularButtons())
+		FVector2f AimDelta;
+		if (Settings.bEnableGyroAim && GyroAimers[DeviceContext.GetIndex()].ConsumeAimDelta(AimDelta))
 		{
-			ProcessButton(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, ButtonName, ButtonIndex,
-			              (PreviousInput.buttonMap & ButtonFlag) > 0,
-			              (Input.buttonMap & ButtonFlag) > 0, Time);
-			ButtonIndex += 1;
+			MessageHandler->OnControllerAnalog(DsConstants::GyroAimAxisXKey.GetFName(), PlatformUserId, InputDeviceId, AimDelta.X);
+			MessageHandler->OnControllerAnalog(DsConstants::GyroAimAxisYKey.GetFName(), PlatformUserId, InputDeviceId, AimDelta.Y);
 		}
 
-		// Virtual buttons.
-
-		ProcessButton(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftStickUp, ButtonIndex,
-		              PreviousInput.leftStick.y > DsConstants::StickDeadZone, Input.leftStick.y > DsConstants::StickDeadZone, Time);
-		ButtonIndex += 1;
+		// Accelerometer and gravity. Both are updated on every report, but sent only once per frame.
 
-		ProcessButton(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftStickDown, ButtonIndex,
-		              PreviousInput.leftStick.y < -DsConstants::StickDeadZone, Input.leftStick.y < -DsConstants::StickDeadZone, Time);
-		ButtonIndex += 1;
+		const auto& Motion{MotionStates[DeviceContext.GetIndex()]};
 
-		ProcessButton(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftStickLeft, ButtonIndex,
-		              PreviousInput.leftStick.x < -DsConstants::StickDeadZone, Input.leftStick.x < -DsConstants::StickDeadZone, Time);
-		ButtonIndex += 1;
+		ProcessMotionAxis(PlatformUserId, InputDeviceId, DsConstants::AccelerometerAxisXKey.GetFName(),
+		                  Extra.SentAccelerometer.X, Motion.Accelerometer.X, Settings.AccelerationChangeThreshold);
+		ProcessMotionAxis(PlatformUserId, InputDeviceId, DsConstants::AccelerometerAxisYKey.GetFName(),
+		                  Extra.SentAccelerometer.Y, Motion.Accelerometer.Y, Settings.AccelerationChangeThreshold);
+		ProcessMotionAxis(PlatformUserId, InputDeviceId, DsConstants::AccelerometerAxisZKey.GetFName(),
+		                  Extra.SentAccelerometer.Z, Motion.Accelerometer.Z, Settings.AccelerationChangeThreshold);
 
-		ProcessButton(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftStickRight, ButtonIndex,
-		              PreviousInput.leftStick.x > DsConstants::StickDeadZone, Input.leftStick.x > DsConstants::StickDeadZone, Time);
-		ButtonIndex += 1;
+		ProcessMotionAxis(PlatformUserId, InputDeviceId, DsConstants::GravityAxisXKey.GetFName(),
+		                  Extra.SentGravity.X, Motion.Gravity.X, Settings.AccelerationChangeThreshold);
+		ProcessMotionAxis(PlatformUserId, InputDeviceId, DsConstants::GravityAxisYKey.GetFName(),
+		                  Extra.SentGravity.Y, Motion.Gravity.Y, Settings.AccelerationChangeThreshold);
+		ProcessMotionAxis(PlatformUserId, InputDeviceId, DsConstants::GravityAxisZKey.GetFName(),
+		                  Extra.SentGravity.Z, Motion.Gravity.Z, Settings.AccelerationChangeThreshold);
 
-		ProcessButton(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, FGamepadKeyNames::RightStickUp, ButtonIndex,
-		              PreviousInput.rightStick.y > DsConstants::StickDeadZone, Input.rightStick.y > DsConstants::StickDeadZone, Time);
-		ButtonIndex += 1;
+		// Motion events.
 
-		ProcessButton(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, FGamepadKeyNames::RightStickDown, ButtonIndex,
-		              PreviousInput.rightStick.y < -DsConstants::StickDeadZone, Input.rightStick.y < -DsConstants::StickDeadZone, Time);
-		ButtonIndex += 1;
+		ProcessMotionEvents(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId);
 
-		ProcessButton(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, FGamepadKeyNames::RightStickLeft, ButtonIndex,
-		              PreviousInput.rightStick.x < -DsConstants::StickDeadZone, Input.rightStick.x < -DsConstants::StickDeadZone, Time);
-		ButtonIndex += 1;
+		// Buttons.
 
-		ProcessButton(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, FGamepadKeyNames::RightStickRight, ButtonIndex,
-		              PreviousInput.rightStick.x > DsConstants::StickDeadZone, Input.rightStick.x > DsConstants::StickDeadZone, Time);
-		ButtonIndex += 1;
+		const auto bEdgeButtons{DeviceModelBindings[DeviceContext.GetIndex()]->Model == EDsDeviceModel::DualSenseEdge};
 
-		// Touch pad.
+		DsKeys::ForEachButton([&]<int32 KeyIndex>(TIntegralConstant<int32, KeyIndex>)
+		{
+			if constexpr (DsKeys::Descriptors[KeyIndex].bEdgeOnly)
+			{
+				if (!bEdgeButtons)
+				{
+					return;
+				}
+			}
 
-		ProcessButton(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, DsConstants::Touch1Key.GetFName(), ButtonIndex,
-		              PreviousInput.touchPoint1.down, Input.touchPoint1.down, Time);
-		ButtonIndex += 1;
+			constexpr auto ButtonIndex{DsKeys::GetButtonIndex(KeyIndex)};
 
-		ProcessButton(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, DsConstants::Touch2Key.GetFName(), ButtonIndex,
-		              PreviousInput.touchPoint2.down, Input.touchPoint2.down, Time);
-		// ReSharper disable once CppAssignedValueIsNeverUsed
-		ButtonIndex += 1;
+			ProcessButton(DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, DsKeys::GetName(KeyIndex), ButtonIndex,
+			              DsKeys::IsButtonDown<KeyIndex>(PreviousInput), DsKeys::IsButtonDown<KeyIndex>(Input), Time);
+		});
 
 		ProcessTouch(PlatformUserId, InputDeviceId, DsConstants::Touch1AxisXKey.GetFName(),
 		             DsConstants::Touch1AxisYKey.GetFName(), PreviousInput.touchPoint1, Input.touchPoint1);
@@ -192,23 +393,35 @@ void FDsInputDevice::SendControllerEvents()
 			const auto TouchAxisX{static_cast<int32>(Input.touchPoint1.x - PreviousInput.touchPoint1.x)};
 			const auto TouchAxisY{static_cast<int32>(Input.touchPoint1.y - PreviousInput.touchPoint1.y)};
 
-			if (GetDefault<UDsSettings>()->bEmitMouseEventsFromTouchpad)
+			if (Settings.bEmitMouseEventsFromTouchpad)
 			{
 				MessageHandler->OnRawMouseMove(TouchAxisX, TouchAxisY);
 			}
 		}
 
-		if (ExtraStates[DeviceContext.GetIndex()].bOutputChanged)
-		{
-			const auto WriteOutputResult{setDeviceOutputState(&Context, &Output)};
-			if (DS5W_FAILED(WriteOutputResult))
-			{
-				UE_LOG(LogFabulousDualSense, Warning, TEXT("Failed to write device output state: %s, Device: %s."),
-				       DsUtility::ReturnValueToString(ReadInputResult).GetData(), Context._internal.devicePath);
+		IdlePolling.FinishPoll(Time, FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - PollStartCycles), Input, Settings);
 
-				DisconnectDevice(InputDeviceMapper, DeviceContext.GetIndex(), PlatformUserId, InputDeviceId);
-			}
-		}
+		AccumulateStageCycles(&FDsStageCycles::EventDispatch, StageStartCycles);
+
+		WriteOutputState(InputDeviceMapper, DeviceContext.GetIndex(), PlatformUserId, InputDeviceId, Time);
+
+		AccumulateStageCycles(&FDsStageCycles::Output, StageStartCycles);
+	}
+}
+
+EDsAnalogSendMode FDsInputDevice::GetAnalogSendMode(const UDsSettings& Settings)
+{
+	return Settings.bSendAnalogOnChangeOnly ? EDsAnalogSendMode::OnChange : EDsAnalogSendMode::EveryFrame;
+}
+
+void FDsInputDevice::AccumulateStageCycles(uint64 FDsStageCycles::* Stage, uint64& StageStartCycles) const
+{
+	if (StageCycles != nullptr)
+	{
+		const auto Cycles{FPlatformTime::Cycles64()};
+
+		StageCycles->*Stage += Cycles - StageStartCycles;
+		StageStartCycles = Cycles;
 	}
 }
 
@@ -219,6 +432,107 @@ void FDsInputDevice::SetMessageHandler(const TSharedRef<FGenericApplicationMessa
 
 bool FDsInputDevice::Exec(UWorld* World, const TCHAR* Command, FOutputDevice& Archive)
 {
+	if (!FParse::Command(&Command, TEXT("DualSense")))
+	{
+		return false;
+	}
+
+	if (FParse::Command(&Command, TEXT("BenchmarkCrc")))
+	{
+		DsBenchmark::RunCrc(Archive);
+		return true;
+	}
+
+	if (FParse::Command(&Command, TEXT("BenchmarkImu")))
+	{
+		DsBenchmark::RunImuCalibration(Archive);
+		return true;
+	}
+
+	if (FParse::Command(&Command, TEXT("BenchmarkDispatch")))
+	{
+		auto FramesCount{600};
+		FParse::Value(Command, TEXT("Frames="), FramesCount);
+
+		BenchmarkDispatch(Archive, FMath::Max(1, FramesCount));
+		return true;
+	}
+
+	if (FParse::Command(&Command, TEXT("CheckAllocations")))
+	{
+		auto FramesCount{3600};
+		FParse::Value(Command, TEXT("Frames="), FramesCount);
+
+		CheckAllocations(Archive, FMath::Max(1, FramesCount));
+		return true;
+	}
+
+	if (FParse::Command(&Command, TEXT("Capture")))
+	{
+		if (FParse::Command(&Command, TEXT("Start")))
+		{
+			auto ControllerId{0};
+			FParse::Value(Command, TEXT("ControllerId="), ControllerId);
+
+			StartCapture(Archive, ControllerId);
+			return true;
+		}
+
+		if (FParse::Command(&Command, TEXT("Stop")))
+		{
+			auto FilePath{FPaths::ProjectSavedDir() / TEXT("FabulousDualSense") / TEXT("InputCapture.bin")};
+			FParse::Value(Command, TEXT("File="), FilePath);
+
+			StopCapture(Archive, FilePath);
+			return true;
+		}
+
+		return false;
+	}
+
+	if (FParse::Command(&Command, TEXT("Diagnostics")))
+	{
+		if (FSlateApplication::IsInitialized())
+		{
+			SDsDiagnosticsPanel::OpenTab();
+		}
+		else
+		{
+			Archive.Log(TEXT("Diagnostics panel requires a Slate application."));
+		}
+
+		return true;
+	}
+
+	if (FParse::Command(&Command, TEXT("Stats")))
+	{
+		for (const auto DeviceContext : EnumerateRange(DeviceContexts))
+		{
+			FDsLinkQualityStatistics LinkQuality;
+			if (!GetLinkQuality(DeviceContext.GetIndex(), LinkQuality))
+			{
+				continue;
+			}
+
+			Archive.Logf(TEXT("Device %d (%s): Received: %llu, Missed: %llu, Overflowed: %llu, Duplicated: %llu, Corrupted: %llu, ")
+			             TEXT("Timestamp Gaps: %llu, Loss Rate: %.2f%%, Report Interval: %.3f ms, Jitter: %.3f ms."),
+			             DeviceContext.GetIndex(), DsUtility::DeviceConnectionToString(DeviceContext->_internal.connectionType).GetData(),
+			             LinkQuality.ReceivedReportsCount, LinkQuality.MissedReportsCount, LinkQuality.OverflowedReportsCount,
+			             LinkQuality.DuplicatedReportsCount, LinkQuality.CorruptedReportsCount, LinkQuality.TimestampGapsCount,
+			             LinkQuality.LossRate * 100.0f, LinkQuality.ReportIntervalMs, LinkQuality.JitterMs);
+
+			FDsPollingStatistics Polling;
+			GetPolling(DeviceContext.GetIndex(), Polling);
+
+			Archive.Logf(TEXT("Device %d: %s, Active Time: %.1f s, Idle Time: %.1f s, Polls: %llu, Skipped Polls: %llu, ")
+			             TEXT("Saved CPU Time: %.3f ms."),
+			             DeviceContext.GetIndex(), Polling.bIdle ? TEXT("Idle") : TEXT("Active"), Polling.ActiveTime,
+			             Polling.IdleTime, Polling.PollsCount, Polling.SkippedPollsCount, Polling.SavedCpuTime * 1000.0);
+		}
+
+		return true;
+	}
+
 	return false;
 }
 
@@ -292,290 +606,1442 @@ void FDsInputDevice::SetChannelValues(const int32 ControllerId, const FForceFeed
 
 void FDsInputDevice::SetDeviceProperty(const int32 ControllerId, const FInputDeviceProperty* Property)
 {
-	if (ControllerId < 0 || ControllerId >= DsConstants::MaxDevicesCount || !DeviceContexts[ControllerId]._internal.connected)
-	{
-		return;
-	}
+	SetDeviceProperties(ControllerId, MakeArrayView(&Property, 1));
+}
 
-	auto& Output{OutputStates[ControllerId]};
-	auto& Extra{ExtraStates[ControllerId]};
+bool FDsInputDevice::IsGamepadAttached() const
+{
+	auto bResult{false};
 
-	if (Property->Name == FInputDeviceLightColorProperty::PropertyName())
+	for (const auto DeviceContext : EnumerateRange(DeviceContexts))
 	{
-		const auto& LightColorProperty{static_cast<const FInputDeviceLightColorProperty&>(*Property)};
-
-		Extra.bOutputChanged |= ProcessLightColorProperty(Output, LightColorProperty);
-		return;
+		bResult |= DeviceContext->_internal.connected;
 	}
 
-	if (Property->Name == FInputDeviceTriggerResetProperty::PropertyName())
-	{
-		const auto& TriggerResetProperty{static_cast<const FInputDeviceTriggerResetProperty&>(*Property)};
-
-		Extra.bOutputChanged |= ProcessTriggerResetProperty(Output.leftTriggerEffect, TriggerResetProperty,
-		                                                    EInputDeviceTriggerMask::Left);
+	return bResult;
+}
 
-		Extra.bOutputChanged |= ProcessTriggerResetProperty(Output.rightTriggerEffect, TriggerResetProperty,
-		                                                    EInputDeviceTriggerMask::Right);
+void FDsInputDevice::SetDeviceProperties(const int32 ControllerId, const TConstArrayView<const FInputDeviceProperty*> Properties)
+{
+	if (ControllerId < 0 || ControllerId >= DsConstants::MaxDevicesCount || !DeviceContexts[ControllerId]._internal.connected)
+	{
 		return;
 	}
 
-	if (Property->Name == FInputDeviceTriggerFeedbackProperty::PropertyName())
-	{
-		const auto& TriggerFeedbackProperty{static_cast<const FInputDeviceTriggerFeedbackProperty&>(*Property)};
-
-		Extra.bOutputChanged |= ProcessTriggerFeedbackProperty(Output.leftTriggerEffect, TriggerFeedbackProperty,
-		                                                       EInputDeviceTriggerMask::Left);
+	const auto& PropertyHandlers{GetDevicePropertyHandlers()};
+	auto& Output{OutputStates[ControllerId]};
 
-		Extra.bOutputChanged |= ProcessTriggerFeedbackProperty(Output.rightTriggerEffect, TriggerFeedbackProperty,
-		                                                       EInputDeviceTriggerMask::Right);
-		return;
-	}
+	auto bOutputChanged{false};
 
-	if (Property->Name == FInputDeviceTriggerResistanceProperty::PropertyName())
+	for (const auto* Property : Properties)
 	{
-		const auto& TriggerResistanceProperty{static_cast<const FInputDeviceTriggerResistanceProperty&>(*Property)};
-
-		Extra.bOutputChanged |= ProcessTriggerResistanceProperty(Output.leftTriggerEffect, TriggerResistanceProperty,
-		                                                         EInputDeviceTriggerMask::Left);
+		if (Property == nullptr)
+		{
+			continue;
+		}
 
-		Extra.bOutputChanged |= ProcessTriggerResistanceProperty(Output.rightTriggerEffect, TriggerResistanceProperty,
-		                                                         EInputDeviceTriggerMask::Right);
-		return;
+		const auto* PropertyHandler{PropertyHandlers.Find(Property->Name)};
+		if (PropertyHandler != nullptr)
+		{
+			bOutputChanged |= (*PropertyHandler)(Output, *Property);
+		}
 	}
 
-	if (Property->Name == FInputDeviceTriggerVibrationProperty::PropertyName())
+	ExtraStates[ControllerId].bOutputChanged |= bOutputChanged;
+}
+
+bool FDsInputDevice::GetLinkQuality(const int32 ControllerId, FDsLinkQualityStatistics& Statistics) const
+{
+	if (ControllerId < 0 || ControllerId >= DsConstants::MaxDevicesCount || !DeviceContexts[ControllerId]._internal.connected)
 	{
-		const auto& TriggerVibrationProperty{static_cast<const FInputDeviceTriggerVibrationProperty&>(*Property)};
+		return false;
+	}
 
-		Extra.bOutputChanged |= ProcessTriggerVibrationProperty(Output.leftTriggerEffect, TriggerVibrationProperty,
-		                                                        EInputDeviceTriggerMask::Left);
+	LinkQualityTrackers[ControllerId].GetStatistics(Statistics);
+	return true;
+}
 
-		Extra.bOutputChanged |= ProcessTriggerVibrationProperty(Output.rightTriggerEffect, TriggerVibrationProperty,
-		                                                        EInputDeviceTriggerMask::Right);
+bool FDsInputDevice::GetPolling(const int32 ControllerId, FDsPollingStatistics& Statistics) const
+{
+	if (ControllerId < 0 || ControllerId >= DsConstants::MaxDevicesCount || !DeviceContexts[ControllerId]._internal.connected)
+	{
+		return false;
 	}
+
+	IdlePollingTrackers[ControllerId].GetStatistics(Statistics);
+	return true;
 }
 
-bool FDsInputDevice::IsGamepadAttached() const
+bool FDsInputDevice::GetIo(const int32 ControllerId, FDsIoStatistics& Statistics) const
 {
-	auto bResult{false};
-
-	for (const auto DeviceContext : EnumerateRange(DeviceContexts))
+	if (ControllerId < 0 || ControllerId >= DsConstants::MaxDevicesCount || !DeviceContexts[ControllerId]._internal.connected)
 	{
-		bResult |= DeviceContext->_internal.connected;
+		return false;
 	}
 
-	return bResult;
+	IoTrackers[ControllerId].GetStatistics(Statistics);
+
+	Statistics.bBluetooth = DeviceContexts[ControllerId]._internal.connectionType == DS5W::DeviceConnection::BT;
+	return true;
 }
 
-void FDsInputDevice::RefreshDevices()
+bool FDsInputDevice::CheckAllocations(FOutputDevice& Archive, const int32 FramesCount)
 {
-	static TStaticArray<unsigned int, DsConstants::MaxDevicesCount> KnownDeviceIds;
-	unsigned int KnowDevicesCount{0};
+	FDsSimulatedDevice SimulatedDevice;
 
-	for (const auto DeviceContext : EnumerateRange(DeviceContexts))
+	// Send input events to a handler that ignores them, so that the check doesn't affect the game.
+
+	FSimulatedSession Session{*this, SimulatedDevice, MakeShared<FGenericApplicationMessageHandler>(), Archive, TEXT("Allocation check")};
+	if (!Session.IsConnected())
 	{
-		if (DeviceContext->_internal.connected)
-		{
-			KnownDeviceIds[DeviceContext.GetIndex()] = DeviceContext->_internal.uniqueID;
-			KnowDevicesCount += 1;
-		}
+		return false;
 	}
 
-	static TStaticArray<DS5W::DeviceEnumInfo, DsConstants::MaxDevicesCount> DeviceInfos;
+	Session.AnalogSendMode = GetAnalogSendMode(*GetDefault<UDsSettings>());
 
-	unsigned int DevicesCount{0};
+	const auto ControllerId{Session.GetControllerId()};
 
-	const auto EnumDevicesResult{
-		enumUnknownDevices(DeviceInfos.GetData(), DsConstants::MaxDevicesCount, KnownDeviceIds.GetData(), KnowDevicesCount, &DevicesCount)
-	};
+	// Idle polling is forced on for the duration of the check, with a timeout short enough
+	// to be reached during the warmup of the idle phase, so that the idle path is always covered.
+
+	auto& Settings{*GetMutableDefault<UDsSettings>()};
+
+	const bool bPreviousEnableIdlePolling{Settings.bEnableIdlePolling};
+	const auto PreviousIdleTimeout{Settings.IdleTimeout};
 
-	switch (EnumDevicesResult)
+	ON_SCOPE_EXIT
 	{
-		case DS5W_OK:
-			break;
+		Settings.bEnableIdlePolling = bPreviousEnableIdlePolling;
+		Settings.IdleTimeout = PreviousIdleTimeout;
+	};
 
-		case DS5W_E_INSUFFICIENT_BUFFER:
-			DevicesCount = DsConstants::MaxDevicesCount;
-			break;
+	Settings.bEnableIdlePolling = true;
+	Settings.IdleTimeout = static_cast<float>(FMath::Max(1, FramesCount / 10) * Session.FrameTime * 0.5);
 
-		default:
-			UE_LOG(LogFabulousDualSense, Warning, TEXT("Failed to enumerate devices: %s."),
-			       DsUtility::ReturnValueToString(EnumDevicesResult).GetData());
-			return;
-	}
+	// The device discovery is paused, since the device enumeration allocates and could connect a real controller
+	// in the middle of the check. The rest of the tick only updates the calibration cache, which stays clean,
+	// since simulated devices never store their gyroscope bias.
 
-	auto& InputDeviceMapper{IPlatformInputDeviceMapper::Get()};
-	TStaticBitArray<DsConstants::MaxDevicesCount> ProcessedDeviceIndexes;
+	const bool bPreviousDiscoverDevices{bDiscoverDevices};
+
+	ON_SCOPE_EXIT
+	{
+		bDiscoverDevices = bPreviousDiscoverDevices;
+	};
+
+	bDiscoverDevices = false;
+
+	FInputDeviceLightColorProperty LightColorProperty;
+	const FInputDeviceProperty* LightColorPropertyPointer{&LightColorProperty};
+
+	const auto RunFrames{
+		[&](const int32 Count, const bool bSetDeviceProperties)
+		{
+			for (auto FrameIndex{0}; FrameIndex < Count; FrameIndex++)
+			{
+				if (bSetDeviceProperties)
+				{
+					LightColorProperty.Color = FColor{static_cast<uint8>(FrameIndex), 0, 255};
+					SetDeviceProperty(ControllerId, LightColorPropertyPointer);
+				}
+
+				Session.RunFrame();
+
+				Tick(static_cast<float>(Session.FrameTime));
+			}
+		}
+	};
+
+	// Each phase is warmed up first, so that one-time initialization is not counted.
+
+	const auto RunPhase{
+		[&](const TCHAR* PhaseName, const bool bSetDeviceProperties)
+		{
+			RunFrames(FMath::Max(1, FramesCount / 10), bSetDeviceProperties);
+
+			int64 AllocationsCount;
+
+			{
+				const FDsAllocationCounter AllocationCounter;
+
+				RunFrames(FramesCount, bSetDeviceProperties);
+
+				AllocationsCount = AllocationCounter.GetAllocationsCount();
+			}
+
+			Archive.Logf(TEXT("%s: %d frames, %lld allocations."), PhaseName, FramesCount, AllocationsCount);
+			return AllocationsCount;
+		}
+	};
+
+	int64 SteadyStateAllocationsCount{0};
+
+	SimulatedDevice.bActive = true;
+	SteadyStateAllocationsCount += RunPhase(TEXT("Active"), false);
+	SteadyStateAllocationsCount += RunPhase(TEXT("Active with device properties"), true);
+
+	SimulatedDevice.bActive = false;
+	SteadyStateAllocationsCount += RunPhase(TEXT("Idle"), false);
+
+	const auto& IdlePolling{IdlePollingTrackers[ControllerId]};
+	if (!IdlePolling.IsIdle())
+	{
+		Archive.Logf(ELogVerbosity::Error, TEXT("The device didn't become idle, the idle path was not covered."));
+		return false;
+	}
+
+	// The error path disconnects the device, which is not expected to be allocation-free.
+
+	SimulatedDevice.bFailReads = true;
+
+	int64 DisconnectAllocationsCount;
+
+	{
+		const FDsAllocationCounter AllocationCounter;
+
+		RunFrames(1, false);
+
+		DisconnectAllocationsCount = AllocationCounter.GetAllocationsCount();
+	}
+
+	Archive.Logf(TEXT("Read error and disconnection: %lld allocations (not counted as steady state)."), DisconnectAllocationsCount);
+
+	if (DeviceContexts[ControllerId]._internal.connected)
+	{
+		Archive.Log(TEXT("The simulated device didn't disconnect after a read error."));
+	}
+
+	if (SteadyStateAllocationsCount > 0)
+	{
+		Archive.Logf(ELogVerbosity::Error, TEXT("Allocation check failed: %lld allocations in steady state."), SteadyStateAllocationsCount);
+		return false;
+	}
+
+	Archive.Log(TEXT("Allocation check passed."));
+	return true;
+}
+
+void FDsInputDevice::BenchmarkDispatch(FOutputDevice& Archive, const int32 FramesCount)
+{
+	FDsSimulatedDevice SimulatedDevice;
+	SimulatedDevice.bActive = true;
+
+	const auto EventsCounter{MakeShared<DsInputDevice::FEventsCounter>()};
+
+	FSimulatedSession Session{*this, SimulatedDevice, EventsCounter, Archive, TEXT("Dispatch benchmark")};
+	if (!Session.IsConnected())
+	{
+		return;
+	}
+
+	for (const auto bHoldAnalogInputs : {false, true})
+	{
+		for (const auto AnalogSendMode : {EDsAnalogSendMode::EveryFrame, EDsAnalogSendMode::OnChange})
+		{
+			SimulatedDevice.bHoldAnalogInputs = bHoldAnalogInputs;
+			Session.AnalogSendMode = AnalogSendMode;
+
+			EventsCounter->AnalogEventsCount = 0;
+
+			const auto StartCycles{FPlatformTime::Cycles64()};
+
+			for (auto FrameIndex{0}; FrameIndex < FramesCount; FrameIndex++)
+			{
+				Session.RunFrame();
+			}
+
+			const auto ElapsedTime{FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles)};
+
+			Archive.Logf(TEXT("%s analog inputs, %s: %.2f analog events per frame, %.3f us per frame."),
+			             bHoldAnalogInputs ? TEXT("Held") : TEXT("Moving"),
+			             AnalogSendMode == EDsAnalogSendMode::OnChange ? TEXT("sent on change") : TEXT("sent every frame"),
+			             static_cast<double>(EventsCounter->AnalogEventsCount) / FramesCount,
+			             ElapsedTime * 1000000.0 / FramesCount);
+		}
+	}
+}
+
+bool FDsInputDevice::ReplayCapture(FOutputDevice& Archive, const FDsInputCapture& Capture,
+                                   const FDsReplayOptions& Options, FDsReplayResults& Results)
+{
+	if (Capture.GetReportsCount() <= 0)
+	{
+		Archive.Log(TEXT("Replay requires a capture with at least one report."));
+		return false;
+	}
+
+	// The simulated device takes its model and connection from the capture, so the replay is started before connecting it.
+
+	FDsSimulatedDevice SimulatedDevice;
+	SimulatedDevice.StartReplay(Capture, FPlatformTime::Seconds());
+
+	const auto EventsCounter{MakeShared<DsInputDevice::FEventsCounter>()};
+
+	FSimulatedSession Session{*this, SimulatedDevice, EventsCounter, Archive, TEXT("Replay")};
+	if (!Session.IsConnected())
+	{
+		return false;
+	}
+
+	Session.FrameTime = 1.0 / FMath::Max(1.0f, Options.FrameRate);
+	Session.bRealTime = Options.bRealTime;
+	Session.AnalogSendMode = GetAnalogSendMode(*GetDefault<UDsSettings>());
+
+	const auto RunReplay{
+		[&](const int32 MaxFramesCount)
+		{
+			SimulatedDevice.StartReplay(Capture, Session.GetTime());
+
+			auto FramesCount{0};
+
+			while (!SimulatedDevice.IsReplayFinished() && FramesCount < MaxFramesCount)
+			{
+				Session.RunFrame();
+				FramesCount += 1;
+			}
+
+			return FramesCount;
+		}
+	};
+
+	// Warm up first, so that one-time initialization is not measured.
+
+	RunReplay(60);
+
+	EventsCounter->AnalogEventsCount = 0;
+	EventsCounter->ButtonEventsCount = 0;
+	EventsCounter->MouseEventsCount = 0;
+
+	FDsStageCycles Cycles;
+	StageCycles = &Cycles;
+
+	const auto StartCycles{FPlatformTime::Cycles64()};
+
+	{
+		const FDsAllocationCounter AllocationCounter;
+
+		for (auto LoopIndex{0}; LoopIndex < FMath::Max(1, Options.LoopsCount); LoopIndex++)
+		{
+			Results.FramesCount += RunReplay(TNumericLimits<int32>::Max());
+			Results.ReportsCount += Capture.GetReportsCount();
+		}
+
+		Results.AllocationsCount = AllocationCounter.GetAllocationsCount();
+	}
+
+	Results.ElapsedTime = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+	StageCycles = nullptr;
+
+	Results.ReportProcessingTime = FPlatformTime::ToSeconds64(Cycles.ReportProcessing);
+	Results.EventDispatchTime = FPlatformTime::ToSeconds64(Cycles.EventDispatch);
+	Results.OutputTime = FPlatformTime::ToSeconds64(Cycles.Output);
+
+	Results.AnalogEventsCount = EventsCounter->AnalogEventsCount;
+	Results.ButtonEventsCount = EventsCounter->ButtonEventsCount;
+	Results.MouseEventsCount = EventsCounter->MouseEventsCount;
+
+	return true;
+}
+
+FDsInputDevice::FSimulatedSession::FSimulatedSession(FDsInputDevice& InputDevice, FDsSimulatedDevice& SimulatedDevice,
+                                                     const TSharedRef<FGenericApplicationMessageHandler>& MessageHandler,
+                                                     FOutputDevice& Archive, const TCHAR* SessionName)
+	: InputDevice{InputDevice}, Time{FPlatformTime::Seconds()}
+{
+	if (InputDevice.IsGamepadAttached())
+	{
+		Archive.Logf(TEXT("%s requires all controllers to be disconnected."), SessionName);
+		return;
+	}
+
+	ControllerId = InputDevice.ConnectSimulatedDevice(IPlatformInputDeviceMapper::Get(), SimulatedDevice);
+	if (ControllerId == INDEX_NONE)
+	{
+		Archive.Logf(TEXT("%s requires a free controller ID."), SessionName);
+		return;
+	}
+
+	PreviousMessageHandler = InputDevice.MessageHandler;
+	InputDevice.MessageHandler = MessageHandler;
+}
+
+FDsInputDevice::FSimulatedSession::~FSimulatedSession()
+{
+	if (ControllerId == INDEX_NONE)
+	{
+		return;
+	}
+
+	// The device may have already been disconnected by a simulated read error.
+
+	if (InputDevice.DeviceContexts[ControllerId]._internal.connected)
+	{
+		auto& InputDeviceMapper{IPlatformInputDeviceMapper::Get()};
+
+		auto PlatformUserId{PLATFORMUSERID_NONE};
+		auto InputDeviceId{INPUTDEVICEID_NONE};
+		InputDevice.RemapControllerId(InputDeviceMapper, ControllerId, PlatformUserId, InputDeviceId);
+
+		InputDevice.DisconnectDevice(InputDeviceMapper, ControllerId, PlatformUserId, InputDeviceId);
+	}
+
+	InputDevice.MessageHandler = PreviousMessageHandler;
+}
+
+bool FDsInputDevice::FSimulatedSession::IsConnected() const
+{
+	return ControllerId != INDEX_NONE;
+}
+
+int32 FDsInputDevice::FSimulatedSession::GetControllerId() const
+{
+	return ControllerId;
+}
+
+double FDsInputDevice::FSimulatedSession::GetTime() const
+{
+	return Time;
+}
+
+void FDsInputDevice::FSimulatedSession::RunFrame()
+{
+	if (bRealTime)
+	{
+		FPlatformProcess::SleepNoStats(static_cast<float>(FMath::Max(0.0, Time + FrameTime - FPlatformTime::Seconds())));
+		Time = FPlatformTime::Seconds();
+	}
+	else
+	{
+		Time += FrameTime;
+	}
+
+	InputDevice.ProcessControllerEvents(Time, AnalogSendMode);
+}
+
+void FDsInputDevice::StartCapture(FOutputDevice& Archive, const int32 ControllerId)
+{
+	if (ControllerId < 0 || ControllerId >= DsConstants::MaxDevicesCount ||
+	    !DeviceContexts[ControllerId]._internal.connected || SimulatedDevices[ControllerId] != nullptr)
+	{
+		Archive.Logf(TEXT("Capture requires a connected controller: %d."), ControllerId);
+		return;
+	}
+
+	CaptureRecorder = MakeUnique<FDsInputCaptureRecorder>(ControllerId, *DeviceModelBindings[ControllerId]);
+
+	Archive.Logf(TEXT("Capture of controller %d started."), ControllerId);
+}
+
+void FDsInputDevice::StopCapture(FOutputDevice& Archive, const FString& FilePath)
+{
+	if (!CaptureRecorder.IsValid())
+	{
+		Archive.Log(TEXT("No capture in progress."));
+		return;
+	}
+
+	CaptureRecorder->Update();
+
+	if (CaptureRecorder->GetMissedReportsCount() > 0)
+	{
+		Archive.Logf(ELogVerbosity::Warning, TEXT("Capture missed %llu reports."), CaptureRecorder->GetMissedReportsCount());
+	}
+
+	auto& Capture{CaptureRecorder->Capture};
+
+	if (Capture.SaveToFile(FilePath))
+	{
+		Archive.Logf(TEXT("Capture saved: %s, Reports: %d, Duration: %.2f s."), *FilePath, Capture.GetReportsCount(), Capture.GetDuration());
+	}
+	else
+	{
+		Archive.Logf(ELogVerbosity::Error, TEXT("Failed to save capture: %s."), *FilePath);
+	}
+
+	CaptureRecorder.Reset();
+}
+
+void FDsInputDevice::StartStartupDiscovery()
+{
+	// The task only touches the shared state, which it keeps alive, so that it can outlive the input device.
+
+	StartupDiscovery = MakeShared<FDsStartupDiscovery, ESPMode::ThreadSafe>();
+
+	StartupDiscoveryTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Discovery{StartupDiscovery}]
+	{
+		if (!Discovery->DeviceEnumerator.EnumerateUnknownDevices({}, Discovery->DeviceInfos, Discovery->DevicesCount))
+		{
+			Discovery->DevicesCount = 0;
+			return;
+		}
+
+		// Devices are initialized in parallel, so that the discovery doesn't take longer with more paired devices.
+
+		ParallelFor(Discovery->DevicesCount, [&Discovery](const int32 DeviceIndex)
+		{
+			Discovery->DeviceResults[DeviceIndex] = initDeviceContext(&Discovery->DeviceInfos[DeviceIndex].EnumInfo,
+			                                                          &Discovery->DeviceContexts[DeviceIndex]);
+		});
+	}, LowLevelTasks::ETaskPriority::BackgroundHigh);
+}
+
+void FDsInputDevice::CompleteStartupDiscovery()
+{
+	StartupDiscoveryTask = {};
+
+	const auto Discovery{MoveTemp(StartupDiscovery)};
+
+	// The devices that turned out not to be supported are remembered, so that the refresh doesn't open them again.
+
+	DeviceEnumerator = MoveTemp(Discovery->DeviceEnumerator);
+
+	auto& InputDeviceMapper{IPlatformInputDeviceMapper::Get()};
+
+	for (auto DeviceIndex{0}; DeviceIndex < Discovery->DevicesCount; DeviceIndex++)
+	{
+		// Simulated devices may have been connected in the meantime, so unused IDs are looked up as usual.
+
+		auto ControllerId{INDEX_NONE};
+
+		for (const auto DeviceContext : EnumerateRange(DeviceContexts))
+		{
+			if (DeviceContext->_internal.uniqueID == 0)
+			{
+				ControllerId = DeviceContext.GetIndex();
+				break;
+			}
+		}
+
+		auto& StartupContext{Discovery->DeviceContexts[DeviceIndex]};
+
+		if (ControllerId == INDEX_NONE)
+		{
+			if (DS5W_SUCCESS(Discovery->DeviceResults[DeviceIndex]))
+			{
+				freeDeviceContext(&StartupContext);
+			}
+
+			continue;
+		}
+
+		// No input requests have been issued yet, so the context can be moved to its final place.
+
+		DeviceContexts[ControllerId] = StartupContext;
+		FMemory::Memzero(StartupContext);
+
+		CompleteDeviceConnection(InputDeviceMapper, Discovery->DeviceInfos[DeviceIndex], ControllerId,
+		                         Discovery->DeviceResults[DeviceIndex]);
+	}
+}
+
+void FDsInputDevice::RefreshDevices()
+{
+	TStaticArray<uint32, DsConstants::MaxDevicesCount> KnownDeviceIds;
+	auto KnowDevicesCount{0};
+
+	for (const auto DeviceContext : EnumerateRange(DeviceContexts))
+	{
+		// Devices that are being reconnected are skipped, so that the enumeration doesn't interfere with the reconnection.
+
+		if (DeviceContext->_internal.connected || ReconnectionTrackers[DeviceContext.GetIndex()].IsReconnecting())
+		{
+			KnownDeviceIds[KnowDevicesCount] = DeviceContext->_internal.uniqueID;
+			KnowDevicesCount += 1;
+		}
+	}
+
+	static TStaticArray<FDsDeviceInfo, DsConstants::MaxDevicesCount> DeviceInfos;
+
+	int32 DevicesCount{0};
+
+	if (!DeviceEnumerator.EnumerateUnknownDevices(MakeArrayView(KnownDeviceIds.GetData(), KnowDevicesCount),
+	                                              DeviceInfos, DevicesCount))
+	{
+		return;
+	}
+
+	auto& InputDeviceMapper{IPlatformInputDeviceMapper::Get()};
+	TStaticBitArray<DsConstants::MaxDevicesCount> ProcessedDeviceIndexes;
 
 	// First iteration: process devices reconnection and already connected devices.
 
-	for (unsigned int DeviceIndex{0}; DeviceIndex < DevicesCount; DeviceIndex++)
+	for (auto DeviceIndex{0}; DeviceIndex < DevicesCount; DeviceIndex++)
+	{
+		for (const auto DeviceContext : EnumerateRange(DeviceContexts))
+		{
+			if (DeviceContext->_internal.uniqueID == DeviceInfos[DeviceIndex].EnumInfo._internal.uniqueID)
+			{
+				ProcessedDeviceIndexes[DeviceIndex] = true;
+
+				if (!DeviceContext->_internal.connected)
+				{
+					ConnectDevice(InputDeviceMapper, DeviceInfos[DeviceIndex], DeviceContext.GetIndex());
+				}
+
+				break;
+			}
+		}
+	}
+
+	// Second iteration: process the connection of new devices (without reusing the
+	// IDs of disconnected devices to give them the opportunity to reconnect later).
+
+	for (auto DeviceIndex{0}; DeviceIndex < DevicesCount; DeviceIndex++)
+	{
+		if (ProcessedDeviceIndexes[DeviceIndex])
+		{
+			continue;
+		}
+
+		for (const auto DeviceContext : EnumerateRange(DeviceContexts))
+		{
+			if (DeviceContext->_internal.uniqueID == 0)
+			{
+				ProcessedDeviceIndexes[DeviceIndex] = true;
+
+				ConnectDevice(InputDeviceMapper, DeviceInfos[DeviceIndex], DeviceContext.GetIndex());
+				break;
+			}
+		}
+	}
+
+	// Third iteration: process the connection of new devices (reusing the IDs of
+	// disconnected devices, because there are not enough unused IDs for new devices).
+
+	for (auto DeviceIndex{0}; DeviceIndex < DevicesCount; DeviceIndex++)
+	{
+		if (ProcessedDeviceIndexes[DeviceIndex])
+		{
+			continue;
+		}
+
+		for (const auto DeviceContext : EnumerateRange(DeviceContexts))
+		{
+			if (!DeviceContext->_internal.connected && !ReconnectionTrackers[DeviceContext.GetIndex()].IsReconnecting())
+			{
+				ProcessedDeviceIndexes[DeviceIndex] = true;
+
+				ConnectDevice(InputDeviceMapper, DeviceInfos[DeviceIndex], DeviceContext.GetIndex());
+				break;
+			}
+		}
+	}
+}
+
+void FDsInputDevice::ConnectDevice(IPlatformInputDeviceMapper& InputDeviceMapper,
+                                   FDsDeviceInfo& DeviceInfo, const int32 ControllerId)
+{
+	CompleteDeviceConnection(InputDeviceMapper, DeviceInfo, ControllerId,
+	                         initDeviceContext(&DeviceInfo.EnumInfo, &DeviceContexts[ControllerId]));
+}
+
+void FDsInputDevice::CompleteDeviceConnection(IPlatformInputDeviceMapper& InputDeviceMapper, const FDsDeviceInfo& DeviceInfo,
+                                              const int32 ControllerId, const DS5W_ReturnValue InitializeDeviceContextResult)
+{
+	UE_LOG(LogFabulousDualSense, Log, TEXT("New device found: %s, Model: %s, Connection: %s."), DeviceInfo.EnumInfo._internal.path,
+	       DsUtility::DeviceModelToString(DeviceInfo.Binding->Model).GetData(),
+	       DsUtility::DeviceConnectionToString(DeviceInfo.EnumInfo._internal.connection).GetData());
+
+	if (DS5W_SUCCESS(InitializeDeviceContextResult))
+	{
+		UE_LOG(LogFabulousDualSense, Log, TEXT("Device connected: %s."), DeviceInfo.EnumInfo._internal.path);
+
+		auto& Context{DeviceContexts[ControllerId]};
+
+		CalibrationCache.ResolveCalibration(Context._internal.uniqueID, Context._internal.devicePath,
+		                                    Context._internal.calibrationData, ImuCalibrations[ControllerId]);
+
+		InitializeDeviceState(InputDeviceMapper, ControllerId, *DeviceInfo.Binding);
+
+		ExtraStates[ControllerId].InputBuffersCount = DsInputDevice::SetUpInputBuffers(Context);
+	}
+	else
+	{
+		UE_LOG(LogFabulousDualSense, Warning, TEXT("Failed to initialize device context: %s, Device: %s."),
+		       DsUtility::ReturnValueToString(InitializeDeviceContextResult).GetData(), DeviceInfo.EnumInfo._internal.path);
+
+		FMemory::Memzero(DeviceContexts[ControllerId]);
+	}
+}
+
+void FDsInputDevice::RemapControllerId(IPlatformInputDeviceMapper& InputDeviceMapper, const int32 ControllerId,
+                                       FPlatformUserId& PlatformUserId, FInputDeviceId& InputDeviceId) const
+{
+	if (SimulatedDevices[ControllerId] != nullptr)
+	{
+		PlatformUserId = InputDeviceMapper.GetPrimaryPlatformUser();
+		InputDeviceId = SimulatedInputDeviceIds[ControllerId];
+		return;
+	}
+
+	InputDeviceMapper.RemapControllerIdToPlatformUserAndDevice(ControllerId, PlatformUserId, InputDeviceId);
+}
+
+int32 FDsInputDevice::ConnectSimulatedDevice(IPlatformInputDeviceMapper& InputDeviceMapper, FDsSimulatedDevice& SimulatedDevice)
+{
+	// Prefer unused IDs, so that disconnected devices can still reconnect to their own IDs.
+
+	auto ControllerId{INDEX_NONE};
+
+	for (const auto DeviceContext : EnumerateRange(DeviceContexts))
+	{
+		if (!DeviceContext->_internal.connected && !ReconnectionTrackers[DeviceContext.GetIndex()].IsReconnecting() &&
+		    (ControllerId == INDEX_NONE || DeviceContext->_internal.uniqueID == 0))
+		{
+			ControllerId = DeviceContext.GetIndex();
+		}
+	}
+
+	if (ControllerId == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	SimulatedDevice.InitializeContext(DeviceContexts[ControllerId], 0xD5D5D5D5);
+	SimulatedDevices[ControllerId] = &SimulatedDevice;
+	SimulatedInputDeviceIds[ControllerId] = InputDeviceMapper.AllocateNewInputDeviceId();
+
+	ImuCalibrations[ControllerId].Compile(DeviceContexts[ControllerId]._internal.calibrationData);
+
+	InitializeDeviceState(InputDeviceMapper, ControllerId, SimulatedDevice.GetBinding());
+
+	return ControllerId;
+}
+
+void FDsInputDevice::InitializeDeviceState(IPlatformInputDeviceMapper& InputDeviceMapper, const int32 ControllerId,
+                                           const FDsDeviceModelBinding& Binding)
+{
+	DeviceModelBindings[ControllerId] = &Binding;
+
+	FMemory::Memzero(InputStates[ControllerId]);
+	FMemory::Memzero(OutputStates[ControllerId]);
+	FMemory::Memzero(ExtraStates[ControllerId]);
+
+	MotionStates[ControllerId] = FDsMotionState{};
+	MotionEventDetectors[ControllerId].Reset();
+	InputPredictors[ControllerId].Reset();
+	InputSmoothers[ControllerId].Reset();
+	GyroAimers[ControllerId].Reset();
+	GyroBiasEstimators[ControllerId].Reset();
+
+	FVector3f GyroBias;
+	if (SimulatedDevices[ControllerId] == nullptr &&
+	    CalibrationCache.GetGyroBias(DeviceContexts[ControllerId]._internal.uniqueID, GyroBias))
+	{
+		GyroBiasEstimators[ControllerId].SetBias(GyroBias);
+	}
+
+	LinkQualityTrackers[ControllerId].Reset();
+	IdlePollingTrackers[ControllerId].Reset(FPlatformTime::Seconds());
+	IoTrackers[ControllerId].Reset();
+
+	auto PlatformUserId{PLATFORMUSERID_NONE};
+	auto InputDeviceId{INPUTDEVICEID_NONE};
+	RemapControllerId(InputDeviceMapper, ControllerId, PlatformUserId, InputDeviceId);
+
+	if (SimulatedDevices[ControllerId] == nullptr)
+	{
+		InputDeviceMapper.Internal_MapInputDeviceToUser(InputDeviceId, PlatformUserId, EInputDeviceConnectionState::Connected);
+	}
+}
+
+void FDsInputDevice::DisconnectDevice(IPlatformInputDeviceMapper& InputDeviceMapper, const int32 ControllerId,
+                                      const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId)
+{
+	auto& Context{DeviceContexts[ControllerId]};
+
+	UE_LOG(LogFabulousDualSense, Log, TEXT("Device disconnected: %s."), Context._internal.devicePath);
+
+	StoreGyroBias(ControllerId);
+
+	// Notified before the simulated device is forgotten, since the notification differs for it.
+
+	NotifyDeviceDisconnected(InputDeviceMapper, ControllerId, PlatformUserId, InputDeviceId);
+
+	if (SimulatedDevices[ControllerId] != nullptr)
+	{
+		SimulatedDevices[ControllerId] = nullptr;
+		FMemory::Memzero(Context);
+	}
+	else
+	{
+		CancelInputRequest(ControllerId);
+		freeDeviceContext(&Context);
+	}
+}
+
+void FDsInputDevice::NotifyDeviceDisconnected(IPlatformInputDeviceMapper& InputDeviceMapper, const int32 ControllerId,
+                                              const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId) const
+{
+	ReleaseInput(ControllerId, PlatformUserId, InputDeviceId);
+
+	// Simulated devices are never published, since their controller IDs may belong to real devices outside of the simulation.
+
+	if (SimulatedDevices[ControllerId] == nullptr)
+	{
+		DsInputSnapshot::Publish(ControllerId, FDsInputSnapshot{});
+
+		InputDeviceMapper.Internal_MapInputDeviceToUser(InputDeviceId, PlatformUserId, EInputDeviceConnectionState::Disconnected);
+	}
+}
+
+void FDsInputDevice::ReleaseAllDevices(const double Deadline)
+{
+	auto& InputDeviceMapper{IPlatformInputDeviceMapper::Get()};
+
+	TArray<UE::Tasks::FTask, TInlineAllocator<DsConstants::MaxDevicesCount>> ReleaseTasks;
+	TArray<HANDLE, TInlineAllocator<DsConstants::MaxDevicesCount>> CancellationHandles;
+
+	const auto CurrentProcess{GetCurrentProcess()};
+
+	for (const auto DeviceContext : EnumerateRange(DeviceContexts))
+	{
+		const auto ControllerId{DeviceContext.GetIndex()};
+
+		if (!DeviceContext->_internal.connected && !ReconnectionTrackers[ControllerId].IsReconnecting())
+		{
+			continue;
+		}
+
+		UE_LOG(LogFabulousDualSense, Log, TEXT("Device disconnected: %s."), DeviceContext->_internal.devicePath);
+
+		// The input is released first, since it only depends on the game thread.
+
+		auto PlatformUserId{PLATFORMUSERID_NONE};
+		auto InputDeviceId{INPUTDEVICEID_NONE};
+		RemapControllerId(InputDeviceMapper, ControllerId, PlatformUserId, InputDeviceId);
+
+		NotifyDeviceDisconnected(InputDeviceMapper, ControllerId, PlatformUserId, InputDeviceId);
+
+		StoreGyroBias(ControllerId);
+
+		if (SimulatedDevices[ControllerId] != nullptr)
+		{
+			SimulatedDevices[ControllerId] = nullptr;
+			FMemory::Memzero(*DeviceContext);
+			continue;
+		}
+
+		// The device handle is duplicated, because the original one may be closed by freeDeviceContext() at any moment, while
+		// the duplicate stays valid and refers to the same file object, so it can still be used to cancel the device I/O.
+
+		HANDLE CancellationHandle{nullptr};
+
+		if (DeviceContext->_internal.connected &&
+		    DuplicateHandle(CurrentProcess, DeviceContext->_internal.deviceHandle, CurrentProcess,
+		                    &CancellationHandle, 0, false, DUPLICATE_SAME_ACCESS))
+		{
+			CancellationHandles.Add(CancellationHandle);
+		}
+
+		// The pending input request is canceled and awaited by the task as well, so
+		// that a device stuck in the driver doesn't block the shutdown beyond the deadline.
+
+		auto& Extra{ExtraStates[ControllerId]};
+
+		const bool bInputRequestPending{Extra.bInputRequestPending};
+
+		ReleaseTasks.Emplace(UE::Tasks::Launch(UE_SOURCE_LOCATION, [Context{&*DeviceContext}, bInputRequestPending]
+		{
+			if (bInputRequestPending)
+			{
+				DsInputDevice::CancelInputRequest(*Context);
+			}
+
+			freeDeviceContext(Context);
+			FMemory::Memzero(*Context);
+		}, LowLevelTasks::ETaskPriority::High));
+
+		Extra.bInputRequestPending = false;
+	}
+
+	if (!UE::Tasks::Wait(ReleaseTasks, DsInputDevice::GetRemainingTime(Deadline)))
+	{
+		UE_LOG(LogFabulousDualSense, Warning, TEXT("Devices weren't released within %.3f seconds, abandoning them."), ShutdownTimeBudget);
+
+		// Canceling the I/O may still unblock the remaining tasks, but they are no longer waited for. The device
+		// contexts they and the pending input requests use are leaked, which is better than hanging the engine exit.
+
+		for (const auto CancellationHandle : CancellationHandles)
+		{
+			CancelIoEx(CancellationHandle, nullptr);
+		}
+
+		DeviceContextsStorage.Release();
+	}
+
+	for (const auto CancellationHandle : CancellationHandles)
+	{
+		CloseHandle(CancellationHandle);
+	}
+}
+
+void FDsInputDevice::CancelInputRequest(const int32 ControllerId)
+{
+	auto& Extra{ExtraStates[ControllerId]};
+	if (!Extra.bInputRequestPending)
+	{
+		return;
+	}
+
+	DsInputDevice::CancelInputRequest(DeviceContexts[ControllerId]);
+
+	Extra.bInputRequestPending = false;
+}
+
+void FDsInputDevice::HandleConnectionLost(IPlatformInputDeviceMapper& InputDeviceMapper, const int32 ControllerId,
+                                          const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId, const double Time)
+{
+	const auto& Settings{*GetDefault<UDsSettings>()};
+
+	if (SimulatedDevices[ControllerId] != nullptr || Settings.ReconnectAttemptsCount <= 0)
+	{
+		DisconnectDevice(InputDeviceMapper, ControllerId, PlatformUserId, InputDeviceId);
+		return;
+	}
+
+	// Keep the device context, including the calibration data, and reopen the device handle instead of going through the
+	// device enumeration and initDeviceContext(). The device stays mapped to its user, since most dropouts are brief.
+
+	auto& Context{DeviceContexts[ControllerId]};
+
+	UE_LOG(LogFabulousDualSense, Log, TEXT("Device connection lost, reconnecting: %s."), Context._internal.devicePath);
+
+	CancelInputRequest(ControllerId);
+	shutdownDevice(&Context);
+
+	ReleaseInput(ControllerId, PlatformUserId, InputDeviceId);
+
+	DsInputSnapshot::Publish(ControllerId, FDsInputSnapshot{});
+
+	FMemory::Memzero(InputStates[ControllerId]);
+	FMemory::Memzero(ExtraStates[ControllerId]);
+
+	MotionStates[ControllerId] = FDsMotionState{};
+	MotionEventDetectors[ControllerId].Reset();
+	InputPredictors[ControllerId].Reset();
+	InputSmoothers[ControllerId].Reset();
+	GyroAimers[ControllerId].Reset();
+
+	ReconnectionTrackers[ControllerId].Start(Time, Settings);
+}
+
+void FDsInputDevice::UpdateReconnection(IPlatformInputDeviceMapper& InputDeviceMapper, const int32 ControllerId,
+                                        const double Time, const UDsSettings& Settings)
+{
+	auto& Reconnection{ReconnectionTrackers[ControllerId]};
+	if (!Reconnection.ShouldAttempt(Time))
+	{
+		return;
+	}
+
+	auto& Context{DeviceContexts[ControllerId]};
+
+	if (DS5W_SUCCESS(reconnectDevice(&Context)))
+	{
+		UE_LOG(LogFabulousDualSense, Log, TEXT("Device reconnected after %d failed attempts: %s."),
+		       Reconnection.GetFailedAttemptsCount(), Context._internal.devicePath);
+
+		Reconnection.Stop();
+
+		// The device may have lost its output state while it was unreachable.
+
+		ExtraStates[ControllerId].bOutputChanged = true;
+
+		// The device handle was reopened, so the input buffers have to be set up again.
+
+		ExtraStates[ControllerId].InputBuffersCount = DsInputDevice::SetUpInputBuffers(Context);
+
+		LinkQualityTrackers[ControllerId].Resynchronize();
+		IdlePollingTrackers[ControllerId].Reset(Time);
+		return;
+	}
+
+	if (Reconnection.AddFailedAttempt(Time, Settings))
+	{
+		return;
+	}
+
+	UE_LOG(LogFabulousDualSense, Log, TEXT("Failed to reconnect device after %d attempts: %s."),
+	       Reconnection.GetFailedAttemptsCount(), Context._internal.devicePath);
+
+	Reconnection.Stop();
+
+	// The device will be connected again by the device enumeration when it becomes available.
+
+	auto PlatformUserId{PLATFORMUSERID_NONE};
+	auto InputDeviceId{INPUTDEVICEID_NONE};
+	RemapControllerId(InputDeviceMapper, ControllerId, PlatformUserId, InputDeviceId);
+
+	DisconnectDevice(InputDeviceMapper, ControllerId, PlatformUserId, InputDeviceId);
+}
+
+void FDsInputDevice::StoreGyroBias(const int32 ControllerId)
+{
+	// Simulated devices share the same unique ID and have no calibration cache entry anyway.
+
+	FVector3f GyroBias;
+	if (SimulatedDevices[ControllerId] == nullptr && GyroBiasEstimators[ControllerId].GetBias(GyroBias))
+	{
+		CalibrationCache.SetGyroBias(DeviceContexts[ControllerId]._internal.uniqueID, GyroBias);
+	}
+}
+
+void FDsInputDevice::ReleaseInput(const int32 ControllerId, const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId) const
+{
+	// Slate isn't initialized in commandlets, such as the headless replay.
+
+	if (!FSlateApplication::IsInitialized() || !FSlateApplication::Get().GetPlatformApplication().IsValid())
 	{
-		for (const auto DeviceContext : EnumerateRange(DeviceContexts))
-		{
-			if (DeviceContext->_internal.uniqueID == DeviceInfos[DeviceIndex]._internal.uniqueID)
-			{
-				ProcessedDeviceIndexes[DeviceIndex] = true;
+		return;
+	}
 
-				if (!DeviceContext->_internal.connected)
-				{
-					ConnectDevice(InputDeviceMapper, DeviceInfos[DeviceIndex], DeviceContext.GetIndex());
-				}
+	const auto& Input{InputStates[ControllerId]};
 
-				break;
-			}
-		}
+	// Release sticks.
+
+	ReleaseStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftAnalogX, Input.leftStick.x);
+	ReleaseStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftAnalogY, Input.leftStick.y);
+
+	ReleaseStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::RightAnalogX, Input.rightStick.x);
+	ReleaseStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::RightAnalogY, Input.rightStick.y);
+
+	// Release triggers.
+
+	if (Input.leftTrigger != 0)
+	{
+		MessageHandler->OnControllerAnalog(FGamepadKeyNames::LeftTriggerAnalog, PlatformUserId, InputDeviceId, 0.0f);
 	}
 
-	// Second iteration: process the connection of new devices (without reusing the
-	// IDs of disconnected devices to give them the opportunity to reconnect later).
+	if (Input.rightTrigger != 0)
+	{
+		MessageHandler->OnControllerAnalog(FGamepadKeyNames::RightTriggerAnalog, PlatformUserId, InputDeviceId, 0.0f);
+	}
+
+	// Release accelerometer and gravity.
+
+	const auto& Extra{ExtraStates[ControllerId]};
+
+	ReleaseAxis(PlatformUserId, InputDeviceId, DsConstants::AccelerometerAxisXKey.GetFName(), Extra.SentAccelerometer.X);
+	ReleaseAxis(PlatformUserId, InputDeviceId, DsConstants::AccelerometerAxisYKey.GetFName(), Extra.SentAccelerometer.Y);
+	ReleaseAxis(PlatformUserId, InputDeviceId, DsConstants::AccelerometerAxisZKey.GetFName(), Extra.SentAccelerometer.Z);
+
+	ReleaseAxis(PlatformUserId, InputDeviceId, DsConstants::GravityAxisXKey.GetFName(), Extra.SentGravity.X);
+	ReleaseAxis(PlatformUserId, InputDeviceId, DsConstants::GravityAxisYKey.GetFName(), Extra.SentGravity.Y);
+	ReleaseAxis(PlatformUserId, InputDeviceId, DsConstants::GravityAxisZKey.GetFName(), Extra.SentGravity.Z);
+
+	// Release motion events.
 
-	for (unsigned int DeviceIndex{0}; DeviceIndex < DevicesCount; DeviceIndex++)
+	ReleaseButton(PlatformUserId, InputDeviceId, DsConstants::ShakeKey.GetFName(),
+	              EnumHasAnyFlags(Extra.SentMotionEvents, EDsMotionEvents::Shake));
+	ReleaseButton(PlatformUserId, InputDeviceId, DsConstants::FlickLeftKey.GetFName(),
+	              EnumHasAnyFlags(Extra.SentMotionEvents, EDsMotionEvents::FlickLeft));
+	ReleaseButton(PlatformUserId, InputDeviceId, DsConstants::FlickRightKey.GetFName(),
+	              EnumHasAnyFlags(Extra.SentMotionEvents, EDsMotionEvents::FlickRight));
+	ReleaseButton(PlatformUserId, InputDeviceId, DsConstants::FlickUpKey.GetFName(),
+	              EnumHasAnyFlags(Extra.SentMotionEvents, EDsMotionEvents::FlickUp));
+	ReleaseButton(PlatformUserId, InputDeviceId, DsConstants::FlickDownKey.GetFName(),
+	              EnumHasAnyFlags(Extra.SentMotionEvents, EDsMotionEvents::FlickDown));
+	ReleaseButton(PlatformUserId, InputDeviceId, DsConstants::FaceDownKey.GetFName(),
+	              EnumHasAnyFlags(Extra.SentMotionEvents, EDsMotionEvents::FaceDown));
+	ReleaseButton(PlatformUserId, InputDeviceId, DsConstants::UprightKey.GetFName(),
+	              EnumHasAnyFlags(Extra.SentMotionEvents, EDsMotionEvents::Upright));
+
+	// Release buttons.
+
+	DsKeys::ForEachButton([&]<int32 KeyIndex>(TIntegralConstant<int32, KeyIndex>)
 	{
-		if (ProcessedDeviceIndexes[DeviceIndex])
+		ReleaseButton(PlatformUserId, InputDeviceId, DsKeys::GetName(KeyIndex), DsKeys::IsButtonDown<KeyIndex>(Input));
+	});
+}
+
+DS5W_ReturnValue FDsInputDevice::ReadInputReports(const int32 ControllerId, const double Time)
+{
+	// Read all input reports received since the previous frame instead of only the latest one, so that
+	// every report can be validated and accounted for. The read request that is still pending at the end
+	// of the frame is completed during the next frame, so this function never blocks.
+
+	auto& Context{DeviceContexts[ControllerId]};
+	auto& Extra{ExtraStates[ControllerId]};
+
+	auto* SimulatedDevice{SimulatedDevices[ControllerId]};
+	if (SimulatedDevice != nullptr)
+	{
+		if (SimulatedDevice->bFailReads)
 		{
-			continue;
+			return DS5W_E_IO_FAILED;
 		}
 
-		for (const auto DeviceContext : EnumerateRange(DeviceContexts))
+		if (SimulatedDevice->IsReplaying())
 		{
-			if (DeviceContext->_internal.uniqueID == 0)
+			while (SimulatedDevice->ReadCapturedReport(Time, Context._internal.hidInBuffer))
 			{
-				ProcessedDeviceIndexes[DeviceIndex] = true;
-
-				ConnectDevice(InputDeviceMapper, DeviceInfos[DeviceIndex], DeviceContext.GetIndex());
-				break;
+				ProcessInputReport(ControllerId, Time);
 			}
+
+			return DS5W_OK;
+		}
+
+		for (auto ReportIndex{0}; ReportIndex < SimulatedDevice->ReportsPerFrame; ReportIndex++)
+		{
+			SimulatedDevice->WriteInputReport(Context._internal.hidInBuffer);
+			ProcessInputReport(ControllerId, Time);
 		}
+
+		return DS5W_OK;
 	}
 
-	// Third iteration: process the connection of new devices (reusing the IDs of
-	// disconnected devices, because there are not enough unused IDs for new devices).
+	auto& LinkQuality{LinkQualityTrackers[ControllerId]};
+	LinkQuality.BeginBatch();
+
+	auto ReportsCount{0};
+	auto bBufferDrained{false};
 
-	for (unsigned int DeviceIndex{0}; DeviceIndex < DevicesCount; DeviceIndex++)
+	for (auto ReportIndex{0}; ReportIndex < DsConstants::MaxInputReportsPerFrame; ReportIndex++)
 	{
-		if (ProcessedDeviceIndexes[DeviceIndex])
+		if (Extra.bInputRequestPending)
 		{
-			continue;
-		}
+			::DWORD BytesTransferred{0};
+			if (!GetOverlappedResult(Context._internal.deviceHandle, &Context._internal.olRead, &BytesTransferred, false))
+			{
+				if (GetLastError() == ERROR_IO_INCOMPLETE)
+				{
+					bBufferDrained = true;
+					break;
+				}
 
-		for (const auto DeviceContext : EnumerateRange(DeviceContexts))
+				Extra.bInputRequestPending = false;
+				return DS5W_E_IO_FAILED;
+			}
+
+			Extra.bInputRequestPending = false;
+		}
+		else
 		{
-			if (!DeviceContext->_internal.connected)
+			const auto StartRequestResult{startInputRequest(&Context)};
+			if (StartRequestResult == DS5W_E_IO_PENDING)
 			{
-				ProcessedDeviceIndexes[DeviceIndex] = true;
+				Extra.bInputRequestPending = true;
+				continue;
+			}
 
-				ConnectDevice(InputDeviceMapper, DeviceInfos[DeviceIndex], DeviceContext.GetIndex());
-				break;
+			if (DS5W_FAILED(StartRequestResult))
+			{
+				return StartRequestResult;
 			}
 		}
+
+		ProcessInputReport(ControllerId, Time);
+
+		ReportsCount += 1;
 	}
+
+	// If the frame couldn't drain the input buffer of the OS, or drained it full, the buffer may have overflowed since
+	// the previous frame. The gap left by the reports dropped by the OS must not be mistaken for a radio loss.
+
+	LinkQuality.EndBatch(!bBufferDrained || ReportsCount >= Extra.InputBuffersCount);
+
+	return DS5W_OK;
 }
 
-void FDsInputDevice::ConnectDevice(IPlatformInputDeviceMapper& InputDeviceMapper,
-                                   DS5W::DeviceEnumInfo& DeviceInfo, const int32 ControllerId)
+void FDsInputDevice::ProcessInputReport(const int32 ControllerId, const double Time)
 {
-	UE_LOG(LogFabulousDualSense, Log, TEXT("New device found: %s, Connection: %s."),
-	       DeviceInfo._internal.path, DsUtility::DeviceConnectionToString(DeviceInfo._internal.connection).GetData());
+	auto& Context{DeviceContexts[ControllerId]};
+	auto& LinkQuality{LinkQualityTrackers[ControllerId]};
 
-	const auto InitializeDeviceContextResult{initDeviceContext(&DeviceInfo, &DeviceContexts[ControllerId])};
-	if (DS5W_SUCCESS(InitializeDeviceContextResult))
+	const auto& Binding{*DeviceModelBindings[ControllerId]};
+
+	const auto* Report{Context._internal.hidInBuffer};
+
+	if (Binding.Connection == DS5W::DeviceConnection::BT &&
+	    (Report[0] != Binding.InputReportId || !DsReport::IsBluetoothReportValid(DsReport::InputReportCrcSeed, Report, Binding.InputReportSize)))
 	{
-		UE_LOG(LogFabulousDualSense, Log, TEXT("Device connected: %s."), DeviceInfo._internal.path);
+		// Drop the corrupted report, otherwise it will turn into phantom input.
 
-		FMemory::Memzero(InputStates[ControllerId]);
-		FMemory::Memzero(OutputStates[ControllerId]);
-		FMemory::Memzero(ExtraStates[ControllerId]);
+		LinkQuality.AddCorruptedReport();
 
-		auto PlatformUserId{PLATFORMUSERID_NONE};
-		auto InputDeviceId{INPUTDEVICEID_NONE};
-		InputDeviceMapper.RemapControllerIdToPlatformUserAndDevice(ControllerId, PlatformUserId, InputDeviceId);
+		UE_LOG(LogFabulousDualSense, Verbose, TEXT("Corrupted input report dropped, Device: %s."), Context._internal.devicePath);
+		return;
+	}
 
-		InputDeviceMapper.Internal_MapInputDeviceToUser(InputDeviceId, PlatformUserId, EInputDeviceConnectionState::Connected);
+	if (SimulatedDevices[ControllerId] == nullptr)
+	{
+		DsRawReports::Publish(ControllerId, Time, Report, Binding.InputReportSize);
 	}
-	else
+
+	auto& Input{InputStates[ControllerId]};
+	const auto PreviousInput{Input};
+
+	auto& Extra{ExtraStates[ControllerId]};
+	auto& Motion{MotionStates[ControllerId]};
+
+	Binding.DecodeInputReport(Report, ImuCalibrations[ControllerId], Extra.InputSequenceNumber, Input, Motion);
+
+	const auto& Settings{*GetDefault<UDsSettings>()};
+
+	// The gravity vector is filtered on every report, so that the filter doesn't depend on the frame rate.
+
+	const auto DeltaTime{Motion.bHasGravity ? static_cast<float>(Input.deltaTime) / DsReport::SensorTimestampFrequency : 0.0f};
+
+	// The bias is subtracted before anything else sees the gyroscope, including the prediction and the smoothing.
+
+	if (Settings.bEnableGyroBiasCalibration)
 	{
-		UE_LOG(LogFabulousDualSense, Warning, TEXT("Failed to initialize device context: %s, Device: %s."),
-		       DsUtility::ReturnValueToString(InitializeDeviceContextResult).GetData(), DeviceInfo._internal.path);
+		auto& GyroBias{GyroBiasEstimators[ControllerId]};
 
-		FMemory::Memzero(DeviceContexts[ControllerId]);
+		GyroBias.AddSample(Motion, DeltaTime, Settings);
+		GyroBias.Apply(Input, Motion);
 	}
-}
 
-void FDsInputDevice::DisconnectDevice(IPlatformInputDeviceMapper& InputDeviceMapper, const int32 ControllerId,
-                                      const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId)
-{
-	auto& Context{DeviceContexts[ControllerId]};
+	LinkQuality.AddReport(Extra.InputSequenceNumber, Input.currentTime);
 
-	UE_LOG(LogFabulousDualSense, Log, TEXT("Device disconnected: %s."), Context._internal.devicePath);
+	InputPredictors[ControllerId].AddSample(Time, Input);
+
+	Context._internal.timestamp = Input.currentTime;
+
+	if (!Motion.bHasGravity)
+	{
+		Motion.bHasGravity = true;
+		Motion.Gravity = Motion.Accelerometer;
+	}
+	else
+	{
+		const auto Alpha{
+			Settings.GravityFilterTimeConstant > 0.0f
+				? DeltaTime / (Settings.GravityFilterTimeConstant + DeltaTime)
+				: 1.0f
+		};
+
+		Motion.Gravity += (Motion.Accelerometer - Motion.Gravity) * Alpha;
+	}
+
+	Motion.IntegratedGyroscope.X = FMath::UnwindDegrees(Motion.IntegratedGyroscope.X + Motion.Gyroscope.X * DeltaTime);
+	Motion.IntegratedGyroscope.Y = FMath::UnwindDegrees(Motion.IntegratedGyroscope.Y + Motion.Gyroscope.Y * DeltaTime);
+	Motion.IntegratedGyroscope.Z = FMath::UnwindDegrees(Motion.IntegratedGyroscope.Z + Motion.Gyroscope.Z * DeltaTime);
 
-	freeDeviceContext(&Context);
+	MotionEventDetectors[ControllerId].AddSample(Motion, DeltaTime, Settings);
 
-	if (FSlateApplication::Get().GetPlatformApplication().IsValid())
+	if (Settings.bEnableGyroAim)
 	{
-		const auto& Input{InputStates[ControllerId]};
+		GyroAimers[ControllerId].AddSample(Input, Motion, DeltaTime, Settings);
+	}
 
-		// Release sticks.
+	if (Settings.bEnableGyroSmoothing || Settings.bEnableStickSmoothing)
+	{
+		InputSmoothers[ControllerId].AddSample(Input, DeltaTime, Settings);
+	}
 
-		ReleaseStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftAnalogX, Input.leftStick.x);
-		ReleaseStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftAnalogY, Input.leftStick.y);
+	PublishSnapshot(ControllerId, Time);
 
-		ReleaseStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::RightAnalogX, Input.rightStick.x);
-		ReleaseStick(PlatformUserId, InputDeviceId, FGamepadKeyNames::RightAnalogY, Input.rightStick.y);
+	IdlePollingTrackers[ControllerId].AddReport(Time, PreviousInput, Input);
+}
 
-		// Release triggers.
+void FDsInputDevice::PublishSnapshot(const int32 ControllerId, const double Time)
+{
+	const auto& Input{InputStates[ControllerId]};
+	const auto& Motion{MotionStates[ControllerId]};
 
-		if (Input.leftTrigger != 0)
+	static const auto ConvertStick{
+		[](const DS5W::AnalogStick& Stick)
 		{
-			MessageHandler->OnControllerAnalog(FGamepadKeyNames::LeftTriggerAnalog, PlatformUserId, InputDeviceId, 0.0f);
+			const auto ConvertAxis{
+				[](const char Value)
+				{
+					return Value <= 0
+						       ? Value / -static_cast<float>(TNumericLimits<int8>::Min())
+						       : Value / static_cast<float>(TNumericLimits<int8>::Max());
+				}
+			};
+
+			return FVector2f{ConvertAxis(Stick.x), ConvertAxis(Stick.y)};
 		}
+	};
 
-		if (Input.rightTrigger != 0)
+	static const auto ConvertTouch{
+		[](const DS5W::Touch& Touch, FDsTouchSnapshot& TouchSnapshot)
 		{
-			MessageHandler->OnControllerAnalog(FGamepadKeyNames::RightTriggerAnalog, PlatformUserId, InputDeviceId, 0.0f);
+			TouchSnapshot.Position = {static_cast<int32>(Touch.x), static_cast<int32>(Touch.y)};
+			TouchSnapshot.Id = Touch.id;
+			TouchSnapshot.bDown = Touch.down;
 		}
+	};
 
-		// Release regular buttons.
+	FDsInputSnapshot Snapshot;
 
-		for (const auto& [ButtonName, ButtonFlag] : DsConstants::GetRegularButtons())
-		{
-			ReleaseButton(PlatformUserId, InputDeviceId, ButtonName, (Input.buttonMap & ButtonFlag) > 0);
-		}
+	auto& Extra{ExtraStates[ControllerId]};
+	Extra.SnapshotSequenceNumber += 1;
+
+	Snapshot.SequenceNumber = Extra.SnapshotSequenceNumber;
+	Snapshot.Time = Time;
+	Snapshot.SensorTimestamp = Input.currentTime;
+
+	Snapshot.LeftStick = ConvertStick(Input.leftStick);
+	Snapshot.RightStick = ConvertStick(Input.rightStick);
+
+	Snapshot.LeftTrigger = Input.leftTrigger / static_cast<float>(TNumericLimits<uint8>::Max());
+	Snapshot.RightTrigger = Input.rightTrigger / static_cast<float>(TNumericLimits<uint8>::Max());
+
+	Snapshot.Buttons = Input.buttonMap;
+
+	Snapshot.Gyroscope = Motion.Gyroscope;
+	Snapshot.IntegratedGyroscope = Motion.IntegratedGyroscope;
+	Snapshot.Accelerometer = Motion.Accelerometer;
+	Snapshot.Gravity = Motion.Gravity;
+
+	ConvertTouch(Input.touchPoint1, Snapshot.Touches[0]);
+	ConvertTouch(Input.touchPoint2, Snapshot.Touches[1]);
+
+	Snapshot.BatteryLevel = Input.battery.level;
+	Snapshot.bConnected = true;
+	Snapshot.bCharging = Input.battery.charging;
+	Snapshot.bFullyCharged = Input.battery.fullyCharged;
+	Snapshot.bHeadphonesConnected = Input.headPhoneConnected;
+
+	if (SimulatedDevices[ControllerId] == nullptr)
+	{
+		DsInputSnapshot::Publish(ControllerId, Snapshot);
+	}
+}
+
+void FDsInputDevice::WriteOutputState(IPlatformInputDeviceMapper& InputDeviceMapper, const int32 ControllerId,
+                                      const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId, const double Time)
+{
+	auto& Extra{ExtraStates[ControllerId]};
+	if (!Extra.bOutputChanged)
+	{
+		return;
+	}
 
-		// Release virtual buttons.
+	auto& Context{DeviceContexts[ControllerId]};
 
-		ReleaseButton(PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftStickUp, Input.leftStick.y > DsConstants::StickDeadZone);
-		ReleaseButton(PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftStickDown, Input.leftStick.y < -DsConstants::StickDeadZone);
-		ReleaseButton(PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftStickLeft, Input.leftStick.x < -DsConstants::StickDeadZone);
-		ReleaseButton(PlatformUserId, InputDeviceId, FGamepadKeyNames::LeftStickRight, Input.leftStick.x > DsConstants::StickDeadZone);
-		ReleaseButton(PlatformUserId, InputDeviceId, FGamepadKeyNames::RightStickUp, Input.rightStick.y > DsConstants::StickDeadZone);
-		ReleaseButton(PlatformUserId, InputDeviceId, FGamepadKeyNames::RightStickDown, Input.rightStick.y < -DsConstants::StickDeadZone);
-		ReleaseButton(PlatformUserId, InputDeviceId, FGamepadKeyNames::RightStickLeft, Input.rightStick.x < -DsConstants::StickDeadZone);
-		ReleaseButton(PlatformUserId, InputDeviceId, FGamepadKeyNames::RightStickRight, Input.rightStick.x > DsConstants::StickDeadZone);
+	const auto WriteOutputResult{
+		SimulatedDevices[ControllerId] == nullptr ? setDeviceOutputState(&Context, &OutputStates[ControllerId]) : DS5W_OK
+	};
+	if (DS5W_FAILED(WriteOutputResult))
+	{
+		UE_LOG(LogFabulousDualSense, Warning, TEXT("Failed to write device output state: %s, Device: %s."),
+		       DsUtility::ReturnValueToString(WriteOutputResult).GetData(), Context._internal.devicePath);
 
-		// Release touch pad.
+		IoTrackers[ControllerId].AddFailedWrite();
 
-		ReleaseButton(PlatformUserId, InputDeviceId, DsConstants::Touch1Key.GetFName(), Input.touchPoint1.down);
-		ReleaseButton(PlatformUserId, InputDeviceId, DsConstants::Touch2Key.GetFName(), Input.touchPoint2.down);
+		HandleConnectionLost(InputDeviceMapper, ControllerId, PlatformUserId, InputDeviceId, Time);
+		return;
 	}
 
-	InputDeviceMapper.Internal_MapInputDeviceToUser(InputDeviceId, PlatformUserId, EInputDeviceConnectionState::Disconnected);
+	IoTrackers[ControllerId].AddOutputWrite();
+
+	// The device keeps its output state, so there is no need to send it again until something changes.
+
+	Extra.bOutputChanged = false;
 }
 
 void FDsInputDevice::ProcessStick(const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId,
-                                  const FGamepadKeyNames::Type& KeyName, const int8 PreviousValue, const int8 NewValue) const
+                                  const FGamepadKeyNames::Type& KeyName, const int8 PreviousValue, const int8 NewValue,
+                                  const float Correction, float& SentValue, const EDsAnalogSendMode AnalogSendMode,
+                                  const UDsSettings& Settings) const
 {
-	if (PreviousValue != NewValue || FMath::Abs(NewValue) > DsConstants::StickDeadZone)
+	const auto bOutsideDeadZone{FMath::Abs(NewValue) > DsConstants::StickDeadZone};
+
+	auto Value{FDsInputPredictor::NormalizeStickValue(NewValue)};
+
+	if (bOutsideDeadZone)
 	{
-		const auto Scale{
-			NewValue <= 0
-				? 1.0f / -static_cast<float>(TNumericLimits<int8>::Min())
-				: 1.0f / static_cast<float>(TNumericLimits<int8>::Max())
-		};
+		Value = FMath::Clamp(Value + Correction, -1.0f, 1.0f);
+	}
+
+	ProcessAnalog(PlatformUserId, InputDeviceId, KeyName, PreviousValue != NewValue, bOutsideDeadZone,
+	              SentValue, Value, AnalogSendMode, Settings);
+}
+
+void FDsInputDevice::ProcessTrigger(const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId,
+                                    const FGamepadKeyNames::Type& KeyName, const uint8 PreviousValue, const uint8 NewValue,
+                                    float& SentValue, const EDsAnalogSendMode AnalogSendMode, const UDsSettings& Settings) const
+{
+	ProcessAnalog(PlatformUserId, InputDeviceId, KeyName, PreviousValue != NewValue, NewValue > DsConstants::TriggerDeadZone,
+	              SentValue, NewValue / static_cast<float>(TNumericLimits<uint8>::Max()), AnalogSendMode, Settings);
+}
+
+void FDsInputDevice::ProcessAnalog(const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId,
+                                   const FGamepadKeyNames::Type& KeyName, const bool bChanged, const bool bOutsideDeadZone,
+                                   float& SentValue, const float NewValue, const EDsAnalogSendMode AnalogSendMode,
+                                   const UDsSettings& Settings) const
+{
+	bool bSend;
+
+	if (AnalogSendMode != EDsAnalogSendMode::EveryFrame)
+	{
+		// Values are compared with the last sent value rather than the previous one, so that slow movements
+		// still get through, and values inside the dead zone are always sent to let the game see the exact rest value.
+
+		bSend = FMath::Abs(NewValue - SentValue) > Settings.AnalogChangeThreshold ||
+		        (!bOutsideDeadZone && NewValue != SentValue) ||
+		        (AnalogSendMode == EDsAnalogSendMode::OnChangeWithKeepAlive && bOutsideDeadZone);
+	}
+	else
+	{
+		bSend = bChanged || bOutsideDeadZone;
+	}
+
+	if (bSend)
+	{
+		SentValue = NewValue;
+
+		MessageHandler->OnControllerAnalog(KeyName, PlatformUserId, InputDeviceId, NewValue);
+	}
+}
+
+void FDsInputDevice::ProcessMotionAxis(const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId, const FName& KeyName,
+                                       float& SentValue, const float NewValue, const float ChangeThreshold) const
+{
+	if (FMath::Abs(NewValue - SentValue) > ChangeThreshold)
+	{
+		SentValue = NewValue;
+
+		MessageHandler->OnControllerAnalog(KeyName, PlatformUserId, InputDeviceId, NewValue);
+	}
+}
+
+void FDsInputDevice::ProcessMotionEvents(const int32 ControllerId, const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId)
+{
+	static const TPair<FKey, EDsMotionEvents> MotionEventKeys[]{
+		{DsConstants::ShakeKey, EDsMotionEvents::Shake},
+		{DsConstants::FlickLeftKey, EDsMotionEvents::FlickLeft},
+		{DsConstants::FlickRightKey, EDsMotionEvents::FlickRight},
+		{DsConstants::FlickUpKey, EDsMotionEvents::FlickUp},
+		{DsConstants::FlickDownKey, EDsMotionEvents::FlickDown},
+		{DsConstants::FaceDownKey, EDsMotionEvents::FaceDown},
+		{DsConstants::UprightKey, EDsMotionEvents::Upright},
+	};
+
+	auto& Extra{ExtraStates[ControllerId]};
+
+	auto NewMotionEvents{MotionEventDetectors[ControllerId].ConsumeEvents()};
+
+	// Events are sent as a button press followed by a release in the next frame, so an event that
+	// is detected again while its key is still pressed is dropped instead of being merged with it.
+
+	EnumRemoveFlags(NewMotionEvents, Extra.SentMotionEvents & EDsMotionEvents::Pulses);
+
+	for (const auto& [Key, MotionEvent] : MotionEventKeys)
+	{
+		const auto bPreviousKeyDown{EnumHasAnyFlags(Extra.SentMotionEvents, MotionEvent)};
+		const auto bNewKeyDown{EnumHasAnyFlags(NewMotionEvents, MotionEvent)};
 
-		MessageHandler->OnControllerAnalog(KeyName, PlatformUserId, InputDeviceId, NewValue * Scale);
+		if (bPreviousKeyDown != bNewKeyDown)
+		{
+			if (bNewKeyDown)
+			{
+				MessageHandler->OnControllerButtonPressed(Key.GetFName(), PlatformUserId, InputDeviceId, false);
+			}
+			else
+			{
+				MessageHandler->OnControllerButtonReleased(Key.GetFName(), PlatformUserId, InputDeviceId, false);
+			}
+		}
 	}
+
+	Extra.SentMotionEvents = NewMotionEvents;
 }
 
 void FDsInputDevice::ProcessButton(const int32 ControllerId, const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId,
@@ -642,6 +2108,15 @@ void FDsInputDevice::ReleaseStick(const FPlatformUserId PlatformUserId, const FI
 	}
 }
 
+void FDsInputDevice::ReleaseAxis(const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId,
+                                 const FName& KeyName, const float SentValue) const
+{
+	if (SentValue != 0.0f)
+	{
+		MessageHandler->OnControllerAnalog(KeyName, PlatformUserId, InputDeviceId, 0.0f);
+	}
+}
+
 void FDsInputDevice::ReleaseButton(const FPlatformUserId PlatformUserId, const FInputDeviceId InputDeviceId,
                                    const FGamepadKeyNames::Type& KeyName, const bool bPressed) const
 {
@@ -651,6 +2126,61 @@ void FDsInputDevice::ReleaseButton(const FPlatformUserId PlatformUserId, const F
 	}
 }
 
+template <typename PropertyType, bool (*Function)(DS5W::DS5OutputState&, const PropertyType&)>
+bool FDsInputDevice::ProcessOutputProperty(DS5W::DS5OutputState& Output, const FInputDeviceProperty& Property)
+{
+	return Function(Output, static_cast<const PropertyType&>(Property));
+}
+
+template <typename PropertyType, bool (*Function)(DS5W::TriggerEffect&, const PropertyType&, EInputDeviceTriggerMask)>
+bool FDsInputDevice::ProcessTriggerProperty(DS5W::DS5OutputState& Output, const FInputDeviceProperty& Property)
+{
+	const auto& TriggerProperty{static_cast<const PropertyType&>(Property)};
+
+	// Both triggers must be processed, so don't use the short-circuit evaluation here.
+
+	const auto bLeftTriggerChanged{Function(Output.leftTriggerEffect, TriggerProperty, EInputDeviceTriggerMask::Left)};
+	const auto bRightTriggerChanged{Function(Output.rightTriggerEffect, TriggerProperty, EInputDeviceTriggerMask::Right)};
+
+	return bLeftTriggerChanged || bRightTriggerChanged;
+}
+
+const TMap<FName, FDsDevicePropertyHandler>& FDsInputDevice::GetDevicePropertyHandlers()
+{
+	static const TMap<FName, FDsDevicePropertyHandler> PropertyHandlers{
+		{
+			FInputDeviceLightColorProperty::PropertyName(),
+			&ProcessOutputProperty<FInputDeviceLightColorProperty, &ProcessLightColorProperty>
+		},
+		{
+			FDsPlayerLedsProperty::PropertyName(),
+			&ProcessOutputProperty<FDsPlayerLedsProperty, &ProcessPlayerLedsProperty>
+		},
+		{
+			FDsMicLedProperty::PropertyName(),
+			&ProcessOutputProperty<FDsMicLedProperty, &ProcessMicLedProperty>
+		},
+		{
+			FInputDeviceTriggerResetProperty::PropertyName(),
+			&ProcessTriggerProperty<FInputDeviceTriggerResetProperty, &ProcessTriggerResetProperty>
+		},
+		{
+			FInputDeviceTriggerFeedbackProperty::PropertyName(),
+			&ProcessTriggerProperty<FInputDeviceTriggerFeedbackProperty, &ProcessTriggerFeedbackProperty>
+		},
+		{
+			FInputDeviceTriggerResistanceProperty::PropertyName(),
+			&ProcessTriggerProperty<FInputDeviceTriggerResistanceProperty, &ProcessTriggerResistanceProperty>
+		},
+		{
+			FInputDeviceTriggerVibrationProperty::PropertyName(),
+			&ProcessTriggerProperty<FInputDeviceTriggerVibrationProperty, &ProcessTriggerVibrationProperty>
+		},
+	};
+
+	return PropertyHandlers;
+}
+
 bool FDsInputDevice::ProcessLightColorProperty(DS5W::DS5OutputState& Output, const FInputDeviceLightColorProperty& ColorProperty)
 {
 	const auto PreviousColor{Output.lightbar};
@@ -669,6 +2199,60 @@ bool FDsInputDevice::ProcessLightColorProperty(DS5W::DS5OutputState& Output, con
 	return Output.lightbar.r != PreviousColor.r || Output.lightbar.g != PreviousColor.g || Output.lightbar.b != PreviousColor.b;
 }
 
+bool FDsInputDevice::ProcessPlayerLedsProperty(DS5W::DS5OutputState& Output, const FDsPlayerLedsProperty& PlayerLedsProperty)
+{
+	static constexpr uint8 AllPlayerLedsMask{
+		DS5W_OSTATE_PLAYER_LED_LEFT | DS5W_OSTATE_PLAYER_LED_MIDDLE_LEFT | DS5W_OSTATE_PLAYER_LED_MIDDLE |
+		DS5W_OSTATE_PLAYER_LED_MIDDLE_RIGHT | DS5W_OSTATE_PLAYER_LED_RIGHT
+	};
+
+	const auto PreviousPlayerLeds{Output.playerLeds};
+
+	Output.playerLeds.bitmask = PlayerLedsProperty.LedsMask & AllPlayerLedsMask;
+	Output.playerLeds.playerLedFade = PlayerLedsProperty.bFadeIn;
+
+	switch (PlayerLedsProperty.Brightness)
+	{
+		case EDsPlayerLedsBrightness::Low:
+			Output.playerLeds.brightness = DS5W::LedBrightness::LOW;
+			break;
+
+		case EDsPlayerLedsBrightness::Medium:
+			Output.playerLeds.brightness = DS5W::LedBrightness::MEDIUM;
+			break;
+
+		default:
+			Output.playerLeds.brightness = DS5W::LedBrightness::HIGH;
+			break;
+	}
+
+	return Output.playerLeds.bitmask != PreviousPlayerLeds.bitmask ||
+	       Output.playerLeds.playerLedFade != PreviousPlayerLeds.playerLedFade ||
+	       Output.playerLeds.brightness != PreviousPlayerLeds.brightness;
+}
+
+bool FDsInputDevice::ProcessMicLedProperty(DS5W::DS5OutputState& Output, const FDsMicLedProperty& MicLedProperty)
+{
+	const auto PreviousMicLed{Output.microphoneLed};
+
+	switch (MicLedProperty.State)
+	{
+		case EDsMicLedState::On:
+			Output.microphoneLed = DS5W::MicLed::ON;
+			break;
+
+		case EDsMicLedState::Pulse:
+			Output.microphoneLed = DS5W::MicLed::PULSE;
+			break;
+
+		default:
+			Output.microphoneLed = DS5W::MicLed::OFF;
+			break;
+	}
+
+	return Output.microphoneLed != PreviousMicLed;
+}
+
 bool FDsInputDevice::ProcessTriggerResetProperty(DS5W::TriggerEffect& TriggerEffect,
                                                  const FInputDeviceTriggerResetProperty& TriggerProperty,
                                                  const EInputDeviceTriggerMask TriggerMask)
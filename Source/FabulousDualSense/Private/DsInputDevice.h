@@ -2,20 +2,41 @@
 
 #include <DualSenseWindows.h>
 
+#include "DsCalibrationCache.h"
 #include "DsConstants.h"
+#include "DsDeviceEnumeration.h"
+#include "DsGyroAim.h"
+#include "DsGyroBias.h"
+#include "DsIdlePolling.h"
+#include "DsImuCalibration.h"
+#include "DsInputCapture.h"
+#include "DsInputPrediction.h"
+#include "DsInputSmoothing.h"
+#include "DsIoTracker.h"
+#include "DsKeys.h"
+#include "DsLinkQuality.h"
+#include "DsMotionEvents.h"
+#include "DsReconnection.h"
+#include "DsSimulatedDevice.h"
 #include "IInputDevice.h"
 #include "Containers/StaticArray.h"
+#include "Tasks/Task.h"
 
 enum class EInputDeviceTriggerMask : uint8;
+class UDsSettings;
 struct FInputDeviceLightColorProperty;
 struct FInputDeviceTriggerResetProperty;
 struct FInputDeviceTriggerFeedbackProperty;
 struct FInputDeviceTriggerResistanceProperty;
 struct FInputDeviceTriggerVibrationProperty;
+struct FDsPlayerLedsProperty;
+struct FDsMicLedProperty;
+
+using FDsDevicePropertyHandler = bool(*)(DS5W::DS5OutputState& Output, const FInputDeviceProperty& Property);
 
 struct FABULOUSDUALSENSE_API FDsExtraState
 {
-	double ButtonsNextRepeatTime[DsConstants::ButtonsCount]{};
+	double ButtonsNextRepeatTime[DsKeys::ButtonsCount]{};
 
 	uint8 ForceFeedbackLeftLarge{0};
 	uint8 ForceFeedbackLeftSmall{0};
@@ -23,19 +44,161 @@ struct FABULOUSDUALSENSE_API FDsExtraState
 	uint8 ForceFeedbackRightLarge{0};
 	uint8 ForceFeedbackRightSmall{0};
 
+	// The last accelerometer and gravity values sent to the message handler.
+
+	FVector3f SentAccelerometer{ForceInit};
+	FVector3f SentGravity{ForceInit};
+
+	EDsMotionEvents SentMotionEvents{EDsMotionEvents::None};
+
+	// The last stick and trigger values sent to the message handler, only used if analog values are sent on change only.
+
+	FVector2f SentLeftStick{ForceInit};
+	FVector2f SentRightStick{ForceInit};
+
+	float SentLeftTrigger{0.0f};
+	float SentRightTrigger{0.0f};
+
+	double NextAnalogKeepAliveTime{0.0};
+
+	uint64 SnapshotSequenceNumber{0};
+
+	// The number of input reports the OS buffers for the device between reads.
+	int32 InputBuffersCount{0};
+
+	// Sequence number of the latest input report, extended to 8 bits for device models with narrower counters.
+	uint8 InputSequenceNumber{0};
+
 	uint8 bOutputChanged : 1 {true};
+
+	uint8 bInputRequestPending : 1 {false};
+
+	// Whether smoothed or extrapolated gyroscope values were sent during the previous frame.
+	uint8 bGyroscopeCorrected : 1 {false};
+};
+
+// Results of the initial device discovery. Shared with its task, so that the task can be abandoned on shutdown if it's stuck in the driver.
+struct FDsStartupDiscovery
+{
+	FDsDeviceEnumerator DeviceEnumerator;
+
+	TStaticArray<FDsDeviceInfo, DsConstants::MaxDevicesCount> DeviceInfos;
+
+	TStaticArray<DS5W::DeviceContext, DsConstants::MaxDevicesCount> DeviceContexts{InPlace, DS5W::DeviceContext{}};
+
+	TStaticArray<DS5W_ReturnValue, DsConstants::MaxDevicesCount> DeviceResults{InPlace, DS5W_OK};
+
+	int32 DevicesCount{0};
+};
+
+// How stick and trigger values are sent. Normally follows the settings, but is passed explicitly,
+// so that the dispatch benchmark can compare the modes without modifying the settings.
+enum class EDsAnalogSendMode : uint8
+{
+	EveryFrame,
+	OnChange,
+
+	// Same as OnChange, but values that stay the same are resent as well, in case the game missed them.
+	OnChangeWithKeepAlive
+};
+
+// Cycles spent in each stage of the input path, accumulated only while a replay measures them.
+struct FDsStageCycles
+{
+	uint64 ReportProcessing{0};
+
+	uint64 EventDispatch{0};
+
+	uint64 Output{0};
 };
 
 class FABULOUSDUALSENSE_API FDsInputDevice : public IInputDevice
 {
 private:
+	// Connects a simulated device and routes the input events to the given message handler for the lifetime of the
+	// session, then disconnects the device and restores the previous message handler. Frames are driven with simulated
+	// time, which would break the timing of real devices, so the session requires all controllers to be disconnected.
+	class FSimulatedSession
+	{
+	private:
+		FDsInputDevice& InputDevice;
+
+		TSharedPtr<FGenericApplicationMessageHandler> PreviousMessageHandler;
+
+		int32 ControllerId{INDEX_NONE};
+
+		double Time{0.0};
+
+	public:
+		double FrameTime{1.0 / 60.0};
+
+		// If enabled, frames are paced by the wall clock, otherwise they are processed as fast as possible.
+		bool bRealTime{false};
+
+		EDsAnalogSendMode AnalogSendMode{EDsAnalogSendMode::EveryFrame};
+
+	public:
+		// Logs the reason with the session name if the device couldn't be connected.
+		FSimulatedSession(FDsInputDevice& InputDevice, FDsSimulatedDevice& SimulatedDevice,
+		                  const TSharedRef<FGenericApplicationMessageHandler>& MessageHandler,
+		                  FOutputDevice& Archive, const TCHAR* SessionName);
+
+		~FSimulatedSession();
+
+		FSimulatedSession(const FSimulatedSession&) = delete;
+
+		FSimulatedSession& operator=(const FSimulatedSession&) = delete;
+
+		bool IsConnected() const;
+
+		int32 GetControllerId() const;
+
+		double GetTime() const;
+
+		// Advances the time by one frame and processes the controller events of that frame.
+		void RunFrame();
+	};
+
 	TSharedPtr<FGenericApplicationMessageHandler> MessageHandler;
 
 	float InitialButtonRepeatDelay{0.2f};
 
 	float ButtonRepeatDelay{0.1f};
 
-	TStaticArray<DS5W::DeviceContext, DsConstants::MaxDevicesCount> DeviceContexts{InPlace, DS5W::DeviceContext{}};
+	// Read in advance, since the settings may no longer be available when the input device is destroyed.
+	float ShutdownTimeBudget{0.1f};
+
+	FDsDeviceEnumerator DeviceEnumerator;
+
+	FDsCalibrationCache CalibrationCache;
+
+	// The initial device discovery runs in the background, so that the engine startup doesn't wait
+	// for initDeviceContext(). Its results are picked up by the first tick after it's finished.
+
+	UE::Tasks::FTask StartupDiscoveryTask;
+
+	TSharedPtr<FDsStartupDiscovery, ESPMode::ThreadSafe> StartupDiscovery;
+
+	// Disabled for headless use, such as replaying captures, where only simulated devices are connected.
+	uint8 bDiscoverDevices : 1 {true};
+
+	// The device contexts live on the heap, so that they can be leaked on shutdown if releasing
+	// the devices takes too long, since the pending input requests still point into them.
+
+	TUniquePtr<TStaticArray<DS5W::DeviceContext, DsConstants::MaxDevicesCount>> DeviceContextsStorage{
+		MakeUnique<TStaticArray<DS5W::DeviceContext, DsConstants::MaxDevicesCount>>(InPlace, DS5W::DeviceContext{})
+	};
+
+	TStaticArray<DS5W::DeviceContext, DsConstants::MaxDevicesCount>& DeviceContexts{*DeviceContextsStorage};
+
+	TStaticArray<const FDsDeviceModelBinding*, DsConstants::MaxDevicesCount> DeviceModelBindings{InPlace, nullptr};
+
+	// Devices that exist only in memory, they don't have a DualSenseWindows context behind them.
+	TStaticArray<FDsSimulatedDevice*, DsConstants::MaxDevicesCount> SimulatedDevices{InPlace, nullptr};
+
+	// Simulated devices get their own input device IDs instead of the ones mapped to their controller IDs,
+	// so that they never show up in the platform input device mapper in place of the real devices.
+	TStaticArray<FInputDeviceId, DsConstants::MaxDevicesCount> SimulatedInputDeviceIds{InPlace, INPUTDEVICEID_NONE};
 
 	TStaticArray<DS5W::DS5InputState, DsConstants::MaxDevicesCount> InputStates{InPlace, DS5W::DS5InputState{}};
 
@@ -43,8 +206,35 @@ private:
 
 	TStaticArray<FDsExtraState, DsConstants::MaxDevicesCount> ExtraStates;
 
+	TStaticArray<FDsImuCalibration, DsConstants::MaxDevicesCount> ImuCalibrations;
+
+	TStaticArray<FDsMotionState, DsConstants::MaxDevicesCount> MotionStates;
+
+	TStaticArray<FDsMotionEventDetector, DsConstants::MaxDevicesCount> MotionEventDetectors;
+
+	TStaticArray<FDsInputPredictor, DsConstants::MaxDevicesCount> InputPredictors;
+
+	TStaticArray<FDsInputSmoother, DsConstants::MaxDevicesCount> InputSmoothers;
+
+	TStaticArray<FDsGyroAimer, DsConstants::MaxDevicesCount> GyroAimers;
+
+	TStaticArray<FDsGyroBiasEstimator, DsConstants::MaxDevicesCount> GyroBiasEstimators;
+
+	TStaticArray<FDsLinkQualityTracker, DsConstants::MaxDevicesCount> LinkQualityTrackers;
+
+	TStaticArray<FDsIdlePollingTracker, DsConstants::MaxDevicesCount> IdlePollingTrackers;
+
+	TStaticArray<FDsIoTracker, DsConstants::MaxDevicesCount> IoTrackers;
+
+	TStaticArray<FDsReconnectionTracker, DsConstants::MaxDevicesCount> ReconnectionTrackers;
+
+	FDsStageCycles* StageCycles{nullptr};
+
+	TUniquePtr<FDsInputCaptureRecorder> CaptureRecorder;
+
 public:
-	explicit FDsInputDevice(const TSharedRef<FGenericApplicationMessageHandler>& MessageHandler);
+	// Without device discovery, real controllers are never enumerated or opened, so only simulated devices can be connected.
+	explicit FDsInputDevice(const TSharedRef<FGenericApplicationMessageHandler>& MessageHandler, bool bDiscoverDevices = true);
 
 	virtual ~FDsInputDevice() override;
 
@@ -64,16 +254,104 @@ public:
 
 	virtual bool IsGamepadAttached() const override;
 
+	void SetDeviceProperties(int32 ControllerId, TConstArrayView<const FInputDeviceProperty*> Properties);
+
+	bool GetLinkQuality(int32 ControllerId, FDsLinkQualityStatistics& Statistics) const;
+
+	bool GetPolling(int32 ControllerId, FDsPollingStatistics& Statistics) const;
+
+	bool GetIo(int32 ControllerId, FDsIoStatistics& Statistics) const;
+
+	// Runs simulated frames through the input path and the tick and returns false if any heap allocations were made
+	// in steady state. Requires all controllers of this input device to be disconnected.
+	bool CheckAllocations(FOutputDevice& Archive, int32 FramesCount);
+
+	// Replays the capture through a simulated device and measures the input path. Requires all controllers to be disconnected.
+	bool ReplayCapture(FOutputDevice& Archive, const FDsInputCapture& Capture, const FDsReplayOptions& Options, FDsReplayResults& Results);
+
 private:
+	void ProcessControllerEvents(double Time, EDsAnalogSendMode AnalogSendMode);
+
+	static EDsAnalogSendMode GetAnalogSendMode(const UDsSettings& Settings);
+
+	void AccumulateStageCycles(uint64 FDsStageCycles::* Stage, uint64& StageStartCycles) const;
+
+	void StartStartupDiscovery();
+
+	void CompleteStartupDiscovery();
+
+	// Runs simulated frames with moving and held analog inputs and reports how many analog events are sent per frame.
+	void BenchmarkDispatch(FOutputDevice& Archive, int32 FramesCount);
+
+	// Records the raw input reports of the controller until the capture is stopped.
+	void StartCapture(FOutputDevice& Archive, int32 ControllerId);
+
+	void StopCapture(FOutputDevice& Archive, const FString& FilePath);
+
 	void RefreshDevices();
 
-	void ConnectDevice(IPlatformInputDeviceMapper& InputDeviceMapper, DS5W::DeviceEnumInfo& DeviceInfo, int32 ControllerId);
+	void RemapControllerId(IPlatformInputDeviceMapper& InputDeviceMapper, int32 ControllerId,
+	                       FPlatformUserId& PlatformUserId, FInputDeviceId& InputDeviceId) const;
+
+	void ConnectDevice(IPlatformInputDeviceMapper& InputDeviceMapper, FDsDeviceInfo& DeviceInfo, int32 ControllerId);
+
+	void CompleteDeviceConnection(IPlatformInputDeviceMapper& InputDeviceMapper, const FDsDeviceInfo& DeviceInfo,
+	                              int32 ControllerId, DS5W_ReturnValue InitializeDeviceContextResult);
+
+	int32 ConnectSimulatedDevice(IPlatformInputDeviceMapper& InputDeviceMapper, FDsSimulatedDevice& SimulatedDevice);
+
+	// Expects the device context and the IMU calibration to be already set up.
+	void InitializeDeviceState(IPlatformInputDeviceMapper& InputDeviceMapper, int32 ControllerId, const FDsDeviceModelBinding& Binding);
 
 	void DisconnectDevice(IPlatformInputDeviceMapper& InputDeviceMapper, int32 ControllerId,
 	                      FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId);
 
-	void ProcessStick(FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId,
-	                  const FGamepadKeyNames::Type& KeyName, int8 PreviousValue, int8 NewValue) const;
+	void NotifyDeviceDisconnected(IPlatformInputDeviceMapper& InputDeviceMapper, int32 ControllerId,
+	                              FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId) const;
+
+	// Releases all connected devices in parallel and abandons the ones that are not released by the deadline.
+	void ReleaseAllDevices(double Deadline);
+
+	// Cancels the pending overlapped read and waits for it, so that the kernel can't complete it into
+	// the device context after the context has been shut down, freed or reused. Must precede both.
+	void CancelInputRequest(int32 ControllerId);
+
+	void HandleConnectionLost(IPlatformInputDeviceMapper& InputDeviceMapper, int32 ControllerId,
+	                          FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId, double Time);
+
+	void UpdateReconnection(IPlatformInputDeviceMapper& InputDeviceMapper, int32 ControllerId, double Time, const UDsSettings& Settings);
+
+	// Stores the latest gyroscope bias estimate of the device in the calibration cache. Only called when the device
+	// is disconnected, since there is no need to save every new estimate while the device is in use.
+	void StoreGyroBias(int32 ControllerId);
+
+	void ReleaseInput(int32 ControllerId, FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId) const;
+
+	DS5W_ReturnValue ReadInputReports(int32 ControllerId, double Time);
+
+	void ProcessInputReport(int32 ControllerId, double Time);
+
+	void PublishSnapshot(int32 ControllerId, double Time);
+
+	void WriteOutputState(IPlatformInputDeviceMapper& InputDeviceMapper, int32 ControllerId,
+	                      FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId, double Time);
+
+	void ProcessStick(FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId, const FGamepadKeyNames::Type& KeyName,
+	                  int8 PreviousValue, int8 NewValue, float Correction, float& SentValue,
+	                  EDsAnalogSendMode AnalogSendMode, const UDsSettings& Settings) const;
+
+	void ProcessTrigger(FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId, const FGamepadKeyNames::Type& KeyName,
+	                    uint8 PreviousValue, uint8 NewValue, float& SentValue, EDsAnalogSendMode AnalogSendMode,
+	                    const UDsSettings& Settings) const;
+
+	void ProcessAnalog(FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId, const FGamepadKeyNames::Type& KeyName,
+	                   bool bChanged, bool bOutsideDeadZone, float& SentValue, float NewValue,
+	                   EDsAnalogSendMode AnalogSendMode, const UDsSettings& Settings) const;
+
+	void ProcessMotionAxis(FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId, const FName& KeyName,
+	                       float& SentValue, float NewValue, float ChangeThreshold) const;
+
+	void ProcessMotionEvents(int32 ControllerId, FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId);
 
 	void ProcessButton(int32 ControllerId, FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId,
 	                   const FGamepadKeyNames::Type& KeyName, int32 ButtonIndex, bool bPreviousKeyDown, bool bNewKeyDown, double Time);
@@ -84,11 +362,25 @@ private:
 	void ReleaseStick(FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId,
 	                  const FGamepadKeyNames::Type& KeyName, int8 CurrentValue) const;
 
+	void ReleaseAxis(FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId, const FName& KeyName, float SentValue) const;
+
 	void ReleaseButton(FPlatformUserId PlatformUserId, FInputDeviceId InputDeviceId,
 	                   const FGamepadKeyNames::Type& KeyName, bool bPressed) const;
 
+	static const TMap<FName, FDsDevicePropertyHandler>& GetDevicePropertyHandlers();
+
+	template <typename PropertyType, bool (*Function)(DS5W::DS5OutputState&, const PropertyType&)>
+	static bool ProcessOutputProperty(DS5W::DS5OutputState& Output, const FInputDeviceProperty& Property);
+
+	template <typename PropertyType, bool (*Function)(DS5W::TriggerEffect&, const PropertyType&, EInputDeviceTriggerMask)>
+	static bool ProcessTriggerProperty(DS5W::DS5OutputState& Output, const FInputDeviceProperty& Property);
+
 	static bool ProcessLightColorProperty(DS5W::DS5OutputState& Output, const FInputDeviceLightColorProperty& ColorProperty);
 
+	static bool ProcessPlayerLedsProperty(DS5W::DS5OutputState& Output, const FDsPlayerLedsProperty& PlayerLedsProperty);
+
+	static bool ProcessMicLedProperty(DS5W::DS5OutputState& Output, const FDsMicLedProperty& MicLedProperty);
+
 	static bool ProcessTriggerResetProperty(DS5W::TriggerEffect& TriggerEffect,
 	                                        const FInputDeviceTriggerResetProperty& TriggerProperty,
 	                                        EInputDeviceTriggerMask TriggerMask);
@@ -0,0 +1,139 @@
+#include "DsInputPrediction.h"
+
+#include "DsReport.h"
+#include "DsSettings.h"
+
+void FDsInputPredictor::Reset()
+{
+	*this = FDsInputPredictor{};
+}
+
+void FDsInputPredictor::AddSample(const double HostTime, const DS5W::DS5InputState& Input)
+{
+	// Larger gaps between reports, for example after idle polling or a dropout, make the history useless.
+	static constexpr auto MaxSampleInterval{0.02};
+
+	// Allows the clock offset to follow the sensor clock drift, which is far below 1 millisecond per second.
+	static constexpr auto ClockDriftRate{0.001};
+
+	if (ValidSamplesCount <= 0)
+	{
+		SensorTime = 0.0;
+		ClockOffset = HostTime;
+	}
+	else
+	{
+		const auto SensorDeltaTime{static_cast<uint32>(Input.currentTime - PreviousSensorTimestamp) / DsReport::SensorTimestampFrequency};
+
+		if (SensorDeltaTime <= 0.0f || SensorDeltaTime > MaxSampleInterval)
+		{
+			Reset();
+			AddSample(HostTime, Input);
+			return;
+		}
+
+		SensorTime += SensorDeltaTime;
+
+		ClockOffset = FMath::Min(HostTime - SensorTime, ClockOffset + (HostTime - PreviousHostTime) * ClockDriftRate);
+	}
+
+	PreviousSensorTimestamp = Input.currentTime;
+	PreviousHostTime = HostTime;
+
+	for (auto i{SamplesCount - 1}; i > 0; i--)
+	{
+		Samples[i] = Samples[i - 1];
+	}
+
+	auto& Sample{Samples[0]};
+
+	Sample.SensorTime = SensorTime;
+
+	Sample.Values[LeftStickX] = NormalizeStickValue(Input.leftStick.x);
+	Sample.Values[LeftStickY] = NormalizeStickValue(Input.leftStick.y);
+	Sample.Values[RightStickX] = NormalizeStickValue(Input.rightStick.x);
+	Sample.Values[RightStickY] = NormalizeStickValue(Input.rightStick.y);
+
+	Sample.Values[GyroscopeX] = static_cast<float>(Input.gyroscope.x);
+	Sample.Values[GyroscopeY] = static_cast<float>(Input.gyroscope.y);
+	Sample.Values[GyroscopeZ] = static_cast<float>(Input.gyroscope.z);
+
+	ValidSamplesCount = FMath::Min(ValidSamplesCount + 1, SamplesCount);
+}
+
+bool FDsInputPredictor::Predict(const double Time, const UDsSettings& Settings, float (&Deltas)[AxesCount]) const
+{
+	for (auto& Delta : Deltas)
+	{
+		Delta = 0.0f;
+	}
+
+	if (ValidSamplesCount < SamplesCount)
+	{
+		return false;
+	}
+
+	// The timestamps only reveal how much later than the fastest reports the latest one was read, the
+	// minimal transport latency itself is indistinguishable from the clock offset, so it's configured instead.
+
+	const auto SampleAge{Time - (Samples[0].SensorTime + ClockOffset) + Settings.InputPredictionTransportLatency};
+	const auto PredictionTime{static_cast<float>(FMath::Clamp(SampleAge, 0.0, static_cast<double>(Settings.MaxInputPredictionTime)))};
+
+	if (PredictionTime <= 0.0f)
+	{
+		return false;
+	}
+
+	const auto LatestDeltaTime{static_cast<float>(Samples[0].SensorTime - Samples[1].SensorTime)};
+	const auto PreviousDeltaTime{static_cast<float>(Samples[1].SensorTime - Samples[2].SensorTime)};
+
+	for (auto i{0}; i < AxesCount; i++)
+	{
+		const auto LatestVelocity{(Samples[0].Values[i] - Samples[1].Values[i]) / LatestDeltaTime};
+		const auto PreviousVelocity{(Samples[1].Values[i] - Samples[2].Values[i]) / PreviousDeltaTime};
+
+		const auto MaxVelocity{FMath::Max(FMath::Abs(LatestVelocity), FMath::Abs(PreviousVelocity))};
+		if (MaxVelocity <= UE_SMALL_NUMBER)
+		{
+			continue;
+		}
+
+		// The confidence drops when the velocity changes a lot between reports, which happens on direction
+		// changes and with sensor noise. Extrapolating through those would overshoot instead of hiding latency.
+
+		const auto Confidence{1.0f - FMath::Abs(LatestVelocity - PreviousVelocity) / MaxVelocity};
+		if (Confidence < Settings.MinInputPredictionConfidence)
+		{
+			continue;
+		}
+
+		const auto LatestValue{Samples[0].Values[i]};
+		auto PredictedValue{LatestValue + LatestVelocity * PredictionTime};
+
+		PredictedValue = i < GyroscopeX
+			                 ? FMath::Clamp(PredictedValue, -1.0f, 1.0f)
+			                 : FMath::Clamp(PredictedValue, -static_cast<float>(DS_GYRO_RANGE), static_cast<float>(DS_GYRO_RANGE));
+
+		Deltas[i] = PredictedValue - LatestValue;
+	}
+
+	return true;
+}
+
+bool FDsInputPredictor::GetLatestSampleAge(const double Time, double& Age) const
+{
+	if (ValidSamplesCount <= 0)
+	{
+		return false;
+	}
+
+	Age = FMath::Max(0.0, Time - (Samples[0].SensorTime + ClockOffset));
+	return true;
+}
+
+float FDsInputPredictor::NormalizeStickValue(const int8 Value)
+{
+	return Value <= 0
+		       ? Value / -static_cast<float>(TNumericLimits<int8>::Min())
+		       : Value / static_cast<float>(TNumericLimits<int8>::Max());
+}
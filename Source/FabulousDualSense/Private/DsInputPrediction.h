@@ -0,0 +1,62 @@
+#pragma once
+
+#include <DualSenseWindows.h>
+
+class UDsSettings;
+
+// Extrapolates the sticks and the gyroscope from the time the latest input report was sampled by the controller to the
+// time the input is sent to the game. The sensor clock is mapped to the host clock by tracking the smallest observed
+// difference between them, which corresponds to the reports that were read as soon as they arrived.
+class FABULOUSDUALSENSE_API FDsInputPredictor
+{
+public:
+	enum EAxis : uint8
+	{
+		LeftStickX,
+		LeftStickY,
+		RightStickX,
+		RightStickY,
+		GyroscopeX,
+		GyroscopeY,
+		GyroscopeZ,
+		AxesCount
+	};
+
+private:
+	static constexpr auto SamplesCount{3};
+
+	struct FSample
+	{
+		double SensorTime{0.0};
+
+		float Values[AxesCount]{};
+	};
+
+	FSample Samples[SamplesCount];
+
+	int32 ValidSamplesCount{0};
+
+	// Sensor timestamps unwrapped and converted to seconds.
+	double SensorTime{0.0};
+
+	// The smallest observed difference between the host time and the sensor time.
+	double ClockOffset{0.0};
+
+	double PreviousHostTime{0.0};
+
+	uint32 PreviousSensorTimestamp{0};
+
+public:
+	void Reset();
+
+	void AddSample(double HostTime, const DS5W::DS5InputState& Input);
+
+	// Provides the difference between the extrapolated and the latest value of each axis. Axes that can't be
+	// extrapolated with enough confidence get zero. Returns false if there is not enough history to extrapolate.
+	bool Predict(double Time, const UDsSettings& Settings, float (&Deltas)[AxesCount]) const;
+
+	// How much later than the fastest reports the latest report is used. Returns false if there are no reports yet.
+	bool GetLatestSampleAge(double Time, double& Age) const;
+
+	static float NormalizeStickValue(int8 Value);
+};
@@ -0,0 +1,104 @@
+#include "DsInputSmoothing.h"
+
+#include "DsSettings.h"
+
+void FDsOneEuroFilter::Reset()
+{
+	*this = FDsOneEuroFilter{};
+}
+
+float FDsOneEuroFilter::Filter(const float Value, const float DeltaTime, const float MinCutoff, const float Beta)
+{
+	// The derivative is filtered with a fixed cutoff, as recommended by the filter authors.
+	static constexpr auto DerivativeCutoff{1.0f};
+
+	if (!bHasPreviousValue || DeltaTime <= 0.0f)
+	{
+		bHasPreviousValue = true;
+		PreviousValue = Value;
+		PreviousDerivative = 0.0f;
+		return Value;
+	}
+
+	const auto Derivative{(Value - PreviousValue) / DeltaTime};
+
+	PreviousDerivative += (Derivative - PreviousDerivative) * GetAlpha(DeltaTime, DerivativeCutoff);
+
+	const auto Cutoff{MinCutoff + Beta * FMath::Abs(PreviousDerivative)};
+
+	PreviousValue += (Value - PreviousValue) * GetAlpha(DeltaTime, Cutoff);
+	return PreviousValue;
+}
+
+float FDsOneEuroFilter::GetAlpha(const float DeltaTime, const float Cutoff)
+{
+	// Same as 1 / (1 + Tau / DeltaTime), where Tau = 1 / (2 * Pi * Cutoff).
+
+	const auto DeltaTimeCutoff{UE_TWO_PI * Cutoff * DeltaTime};
+	return DeltaTimeCutoff / (1.0f + DeltaTimeCutoff);
+}
+
+void FDsInputSmoother::Reset()
+{
+	*this = FDsInputSmoother{};
+}
+
+void FDsInputSmoother::AddSample(const DS5W::DS5InputState& Input, const float DeltaTime, const UDsSettings& Settings)
+{
+	if (Settings.bEnableStickSmoothing)
+	{
+		const auto FilterStick{
+			[&](const FDsInputPredictor::EAxis Axis, const int8 Value)
+			{
+				Values[Axis] = Filters[Axis].Filter(FDsInputPredictor::NormalizeStickValue(Value), DeltaTime,
+				                                    Settings.StickSmoothingMinCutoff, Settings.StickSmoothingBeta);
+			}
+		};
+
+		FilterStick(FDsInputPredictor::LeftStickX, Input.leftStick.x);
+		FilterStick(FDsInputPredictor::LeftStickY, Input.leftStick.y);
+		FilterStick(FDsInputPredictor::RightStickX, Input.rightStick.x);
+		FilterStick(FDsInputPredictor::RightStickY, Input.rightStick.y);
+	}
+
+	if (Settings.bEnableGyroSmoothing)
+	{
+		// Filtered in degrees per second, so that the beta doesn't depend on the sensor resolution.
+
+		const auto FilterGyroscope{
+			[&](const FDsInputPredictor::EAxis Axis, const int32 Value)
+			{
+				Values[Axis] = Filters[Axis].Filter(static_cast<float>(Value) / DS_GYRO_RES_PER_DEG_S, DeltaTime,
+				                                    Settings.GyroSmoothingMinCutoff, Settings.GyroSmoothingBeta) * DS_GYRO_RES_PER_DEG_S;
+			}
+		};
+
+		FilterGyroscope(FDsInputPredictor::GyroscopeX, Input.gyroscope.x);
+		FilterGyroscope(FDsInputPredictor::GyroscopeY, Input.gyroscope.y);
+		FilterGyroscope(FDsInputPredictor::GyroscopeZ, Input.gyroscope.z);
+	}
+}
+
+void FDsInputSmoother::GetDeltas(const DS5W::DS5InputState& Input, const UDsSettings& Settings,
+                                 float (&Deltas)[FDsInputPredictor::AxesCount]) const
+{
+	for (auto& Delta : Deltas)
+	{
+		Delta = 0.0f;
+	}
+
+	if (Settings.bEnableStickSmoothing)
+	{
+		Deltas[FDsInputPredictor::LeftStickX] = Values[FDsInputPredictor::LeftStickX] - FDsInputPredictor::NormalizeStickValue(Input.leftStick.x);
+		Deltas[FDsInputPredictor::LeftStickY] = Values[FDsInputPredictor::LeftStickY] - FDsInputPredictor::NormalizeStickValue(Input.leftStick.y);
+		Deltas[FDsInputPredictor::RightStickX] = Values[FDsInputPredictor::RightStickX] - FDsInputPredictor::NormalizeStickValue(Input.rightStick.x);
+		Deltas[FDsInputPredictor::RightStickY] = Values[FDsInputPredictor::RightStickY] - FDsInputPredictor::NormalizeStickValue(Input.rightStick.y);
+	}
+
+	if (Settings.bEnableGyroSmoothing)
+	{
+		Deltas[FDsInputPredictor::GyroscopeX] = Values[FDsInputPredictor::GyroscopeX] - static_cast<float>(Input.gyroscope.x);
+		Deltas[FDsInputPredictor::GyroscopeY] = Values[FDsInputPredictor::GyroscopeY] - static_cast<float>(Input.gyroscope.y);
+		Deltas[FDsInputPredictor::GyroscopeZ] = Values[FDsInputPredictor::GyroscopeZ] - static_cast<float>(Input.gyroscope.z);
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <DualSenseWindows.h>
+
+#include "DsInputPrediction.h"
+
+class UDsSettings;
+
+// One Euro filter, a low-pass filter whose cutoff frequency rises with the speed of the signal, so
+// that it removes jitter at rest while adding almost no lag during fast motion. Costs about 15 flops per sample.
+class FABULOUSDUALSENSE_API FDsOneEuroFilter
+{
+private:
+	float PreviousValue{0.0f};
+
+	float PreviousDerivative{0.0f};
+
+	uint8 bHasPreviousValue : 1 {false};
+
+public:
+	void Reset();
+
+	// The cutoff frequencies are in hertz, the beta is in hertz per unit of the value change per second.
+	float Filter(float Value, float DeltaTime, float MinCutoff, float Beta);
+
+private:
+	static float GetAlpha(float DeltaTime, float Cutoff);
+};
+
+// Smooths the sticks and the gyroscope on every input report, using the sensor time between reports.
+class FABULOUSDUALSENSE_API FDsInputSmoother
+{
+private:
+	FDsOneEuroFilter Filters[FDsInputPredictor::AxesCount];
+
+	// Same units as the input state, except for the sticks, which are normalized.
+	float Values[FDsInputPredictor::AxesCount]{};
+
+public:
+	void Reset();
+
+	void AddSample(const DS5W::DS5InputState& Input, float DeltaTime, const UDsSettings& Settings);
+
+	// Provides the difference between the smoothed and the latest value of each axis, zero for axes that are not smoothed.
+	void GetDeltas(const DS5W::DS5InputState& Input, const UDsSettings& Settings, float (&Deltas)[FDsInputPredictor::AxesCount]) const;
+};
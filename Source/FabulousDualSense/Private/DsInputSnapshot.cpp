@@ -0,0 +1,64 @@
+#include "DsInputSnapshot.h"
+
+#include <atomic>
+
+#include "DsConstants.h"
+#include "DsInputSnapshotPublisher.h"
+
+namespace DsInputSnapshot
+{
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FSequenceLockedSnapshot
+	{
+		// Odd while the snapshot is being written.
+		std::atomic<uint32> SequenceLock{0};
+
+		FDsInputSnapshot Snapshot;
+	};
+
+	FSequenceLockedSnapshot Snapshots[DsConstants::MaxDevicesCount];
+}
+
+bool DsInputSnapshot::Read(const int32 ControllerId, FDsInputSnapshot& Snapshot)
+{
+	if (ControllerId < 0 || ControllerId >= DsConstants::MaxDevicesCount)
+	{
+		return false;
+	}
+
+	const auto& LockedSnapshot{Snapshots[ControllerId]};
+
+	while (true)
+	{
+		const auto SequenceLock{LockedSnapshot.SequenceLock.load(std::memory_order_acquire)};
+		if ((SequenceLock & 1) != 0)
+		{
+			FPlatformProcess::YieldThread();
+			continue;
+		}
+
+		FMemory::Memcpy(Snapshot, LockedSnapshot.Snapshot);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (LockedSnapshot.SequenceLock.load(std::memory_order_relaxed) == SequenceLock)
+		{
+			return Snapshot.bConnected;
+		}
+	}
+}
+
+void DsInputSnapshot::Publish(const int32 ControllerId, const FDsInputSnapshot& Snapshot)
+{
+	check(ControllerId >= 0 && ControllerId < DsConstants::MaxDevicesCount);
+
+	auto& LockedSnapshot{Snapshots[ControllerId]};
+
+	const auto SequenceLock{LockedSnapshot.SequenceLock.load(std::memory_order_relaxed)};
+
+	LockedSnapshot.SequenceLock.store(SequenceLock + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	FMemory::Memcpy(LockedSnapshot.Snapshot, Snapshot);
+
+	LockedSnapshot.SequenceLock.store(SequenceLock + 2, std::memory_order_release);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "DsInputSnapshot.h"
+
+namespace DsInputSnapshot
+{
+	// Must only be called from the thread that processes input reports.
+	void Publish(int32 ControllerId, const FDsInputSnapshot& Snapshot);
+}
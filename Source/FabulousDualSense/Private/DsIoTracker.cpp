@@ -0,0 +1,61 @@
+#include "DsIoTracker.h"
+
+void FDsIoTracker::Reset()
+{
+	OutputWritesCount.store(0, std::memory_order_relaxed);
+	FailedReadsCount.store(0, std::memory_order_relaxed);
+	FailedWritesCount.store(0, std::memory_order_relaxed);
+
+	for (auto& Count : ReportAgeHistogram)
+	{
+		Count.store(0, std::memory_order_relaxed);
+	}
+}
+
+void FDsIoTracker::AddOutputWrite()
+{
+	Increment(OutputWritesCount);
+}
+
+void FDsIoTracker::AddFailedRead()
+{
+	Increment(FailedReadsCount);
+}
+
+void FDsIoTracker::AddFailedWrite()
+{
+	Increment(FailedWritesCount);
+}
+
+void FDsIoTracker::AddReportAge(const double Age)
+{
+	const auto AgeMs{static_cast<float>(Age * 1000.0)};
+
+	auto BucketIndex{0};
+
+	while (BucketIndex < FDsIoStatistics::ReportAgeBucketsCount - 1 && AgeMs >= FDsIoStatistics::ReportAgeBucketLimitsMs[BucketIndex])
+	{
+		BucketIndex += 1;
+	}
+
+	Increment(ReportAgeHistogram[BucketIndex]);
+}
+
+void FDsIoTracker::GetStatistics(FDsIoStatistics& Statistics) const
+{
+	Statistics.OutputWritesCount = OutputWritesCount.load(std::memory_order_relaxed);
+	Statistics.FailedReadsCount = FailedReadsCount.load(std::memory_order_relaxed);
+	Statistics.FailedWritesCount = FailedWritesCount.load(std::memory_order_relaxed);
+
+	for (auto i{0}; i < FDsIoStatistics::ReportAgeBucketsCount; i++)
+	{
+		Statistics.ReportAgeHistogram[i] = ReportAgeHistogram[i].load(std::memory_order_relaxed);
+	}
+}
+
+void FDsIoTracker::Increment(std::atomic<uint64>& Counter)
+{
+	// There is only one writer, so a plain load and store is enough and avoids a locked instruction.
+
+	Counter.store(Counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
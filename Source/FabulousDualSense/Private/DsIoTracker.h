@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+
+#include "DsStatistics.h"
+
+// Counts device I/O operations with relaxed atomic counters, so that they can be sampled from any thread at any
+// rate without locking and without affecting the input processing. Must only be updated from a single thread.
+class FABULOUSDUALSENSE_API FDsIoTracker
+{
+private:
+	std::atomic<uint64> OutputWritesCount{0};
+
+	std::atomic<uint64> FailedReadsCount{0};
+
+	std::atomic<uint64> FailedWritesCount{0};
+
+	std::atomic<uint64> ReportAgeHistogram[FDsIoStatistics::ReportAgeBucketsCount]{};
+
+public:
+	void Reset();
+
+	void AddOutputWrite();
+
+	void AddFailedRead();
+
+	void AddFailedWrite();
+
+	void AddReportAge(double Age);
+
+	void GetStatistics(FDsIoStatistics& Statistics) const;
+
+private:
+	static void Increment(std::atomic<uint64>& Counter);
+};
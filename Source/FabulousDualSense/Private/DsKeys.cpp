@@ -0,0 +1,84 @@
+#include "DsKeys.h"
+
+#include "Containers/StaticArray.h"
+
+namespace DsKeys
+{
+	static TStaticArray<FName, KeysCount> MakeNames()
+	{
+		TStaticArray<FName, KeysCount> Names;
+
+		for (auto i{0}; i < KeysCount; i++)
+		{
+			Names[i] = FName{Descriptors[i].Name};
+		}
+
+		return Names;
+	}
+
+	static const TStaticArray<FName, KeysCount> Names{MakeNames()};
+
+	using FIsButtonDownFunction = bool(*)(const DS5W::DS5InputState& Input);
+
+	template <int32... KeyIndices>
+	static const FIsButtonDownFunction* GetIsButtonDownFunctions(TIntegerSequence<int32, KeyIndices...>)
+	{
+		static constexpr FIsButtonDownFunction Functions[]{&IsButtonDown<KeyIndices>...};
+
+		return Functions;
+	}
+}
+
+const FName& DsKeys::GetName(const int32 KeyIndex)
+{
+	return Names[KeyIndex];
+}
+
+void DsKeys::RegisterKeys(const FName& CategoryName)
+{
+	for (auto i{0}; i < KeysCount; i++)
+	{
+		const auto& Descriptor{Descriptors[i]};
+
+		if (Descriptor.DisplayName == nullptr)
+		{
+			continue;
+		}
+
+		const FKeyDetails KeyDetails{FKey{Names[i]}, Descriptor.DisplayName(), Descriptor.Flags, CategoryName};
+
+		if (Descriptor.PairedAxisXName != nullptr && Descriptor.PairedAxisYName != nullptr)
+		{
+			EKeys::AddPairedKey(KeyDetails, FKey{FName{Descriptor.PairedAxisXName}}, FKey{FName{Descriptor.PairedAxisYName}});
+		}
+		else
+		{
+			EKeys::AddKey(KeyDetails);
+		}
+	}
+}
+
+int32 DsKeys::FindKeyIndex(const FName& KeyName)
+{
+	if (KeyName.IsNone())
+	{
+		return INDEX_NONE;
+	}
+
+	for (auto i{0}; i < KeysCount; i++)
+	{
+		if (Names[i] == KeyName)
+		{
+			return i;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+bool DsKeys::IsButtonDown(const int32 KeyIndex, const DS5W::DS5InputState& Input)
+{
+	check(KeyIndex >= 0 && KeyIndex < KeysCount);
+
+	return GetIsButtonDownFunctions(TMakeIntegerSequence<int32, KeysCount>{})[KeyIndex](Input);
+}
@@ -0,0 +1,414 @@
+#pragma once
+
+#include <DualSenseWindows.h>
+
+#include "DsConstants.h"
+#include "Internationalization/Internationalization.h"
+#include "Templates/IntegerSequence.h"
+#include "Templates/IntegralConstant.h"
+
+// Where the pressed state of a button key comes from.
+enum class EDsKeySource : uint8
+{
+	// Not a button, or a button that is sent separately, such as the motion events.
+	None,
+	ButtonMap,
+	LeftStickUp,
+	LeftStickDown,
+	LeftStickLeft,
+	LeftStickRight,
+	RightStickUp,
+	RightStickDown,
+	RightStickLeft,
+	RightStickRight,
+	Touch1,
+	Touch2
+};
+
+struct FDsKeyDescriptor
+{
+	// Key names are stored in input mapping assets, so they never change, including the engine ones.
+	const TCHAR* Name{nullptr};
+
+	// Only the plugin's own keys have a display name, the engine keys are not registered again. It's
+	// returned by a function, since texts can't be constant expressions, and is a LOCTEXT, so that it's gathered.
+	FText (*DisplayName)(){nullptr};
+
+	// A combination of FKeyDetails::EKeyFlags.
+	uint32 Flags{0};
+
+	EDsKeySource Source{EDsKeySource::None};
+
+	// The flag in the buttons map, only used by the ButtonMap source.
+	uint32 ButtonFlag{0};
+
+	// Whether the key is a DualSense Edge button. Other models never set these bits, so they are skipped entirely.
+	bool bEdgeOnly{false};
+
+	// The axes of a paired 2D axis key.
+
+	const TCHAR* PairedAxisXName{nullptr};
+	const TCHAR* PairedAxisYName{nullptr};
+};
+
+// The single list of keys handled by the plugin, from which the key registration, the button dispatch and
+// the button release are generated, so that they can't drift apart. Buttons are dispatched in this order.
+namespace DsKeys
+{
+	inline constexpr auto GamepadKey{static_cast<uint32>(FKeyDetails::GamepadKey)};
+	inline constexpr auto TouchKey{static_cast<uint32>(FKeyDetails::GamepadKey | FKeyDetails::Touch)};
+	inline constexpr auto AxisKey{static_cast<uint32>(FKeyDetails::GamepadKey | FKeyDetails::Axis1D | FKeyDetails::UpdateAxisWithoutSamples)};
+	// Absolute values that are sent only when they change, so they must keep their value on frames without samples.
+	inline constexpr auto AbsoluteAxisKey{static_cast<uint32>(FKeyDetails::GamepadKey | FKeyDetails::Axis1D)};
+	inline constexpr auto TouchAxisKey{static_cast<uint32>(AxisKey | FKeyDetails::Touch)};
+	inline constexpr auto TouchPairedAxisKey{
+		static_cast<uint32>(FKeyDetails::GamepadKey | FKeyDetails::Touch | FKeyDetails::Axis2D | FKeyDetails::UpdateAxisWithoutSamples)
+	};
+	inline constexpr auto PairedAxisKey{
+		static_cast<uint32>(FKeyDetails::GamepadKey | FKeyDetails::Axis2D | FKeyDetails::UpdateAxisWithoutSamples)
+	};
+
+#define LOCTEXT_NAMESPACE "FabulousDualSenseModule"
+
+	inline constexpr FDsKeyDescriptor Descriptors[]
+	{
+		// Engine buttons.
+
+		{.Name = TEXT("Gamepad_DPad_Up"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_DPAD_UP},
+		{.Name = TEXT("Gamepad_DPad_Down"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_DPAD_DOWN},
+		{.Name = TEXT("Gamepad_DPad_Left"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_DPAD_LEFT},
+		{.Name = TEXT("Gamepad_DPad_Right"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_DPAD_RIGHT},
+
+		{.Name = TEXT("Gamepad_FaceButton_Top"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_TRIANGLE},
+		{.Name = TEXT("Gamepad_FaceButton_Bottom"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_CROSS},
+		{.Name = TEXT("Gamepad_FaceButton_Left"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_SQUARE},
+		{.Name = TEXT("Gamepad_FaceButton_Right"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_CIRCLE},
+
+		{.Name = TEXT("Gamepad_LeftTrigger"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_TRIGGER_LEFT},
+		{.Name = TEXT("Gamepad_RightTrigger"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_TRIGGER_RIGHT},
+
+		{.Name = TEXT("Gamepad_LeftShoulder"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_BUMPER_LEFT},
+		{.Name = TEXT("Gamepad_RightShoulder"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_BUMPER_RIGHT},
+
+		{.Name = TEXT("Gamepad_LeftThumbstick"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_STICK_LEFT},
+		{.Name = TEXT("Gamepad_RightThumbstick"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_STICK_RIGHT},
+
+		{.Name = TEXT("Gamepad_Special_Left"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_SELECT},
+		{.Name = TEXT("Gamepad_Special_Right"), .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_MENU},
+
+		// Engine virtual buttons.
+
+		{.Name = TEXT("Gamepad_LeftStick_Up"), .Source = EDsKeySource::LeftStickUp},
+		{.Name = TEXT("Gamepad_LeftStick_Down"), .Source = EDsKeySource::LeftStickDown},
+		{.Name = TEXT("Gamepad_LeftStick_Left"), .Source = EDsKeySource::LeftStickLeft},
+		{.Name = TEXT("Gamepad_LeftStick_Right"), .Source = EDsKeySource::LeftStickRight},
+
+		{.Name = TEXT("Gamepad_RightStick_Up"), .Source = EDsKeySource::RightStickUp},
+		{.Name = TEXT("Gamepad_RightStick_Down"), .Source = EDsKeySource::RightStickDown},
+		{.Name = TEXT("Gamepad_RightStick_Left"), .Source = EDsKeySource::RightStickLeft},
+		{.Name = TEXT("Gamepad_RightStick_Right"), .Source = EDsKeySource::RightStickRight},
+
+		// Plugin buttons.
+
+		{
+			.Name = TEXT("DsTouchpad"), .DisplayName = [] { return LOCTEXT("TouchpadKey", "DualSense Touchpad"); },
+			.Flags = GamepadKey, .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_PAD_BUTTON
+		},
+		{
+			.Name = TEXT("DsLogo"), .DisplayName = [] { return LOCTEXT("LogoKey", "DualSense Logo"); },
+			.Flags = GamepadKey, .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_PLAYSTATION_LOGO
+		},
+		{
+			.Name = TEXT("DsMute"), .DisplayName = [] { return LOCTEXT("MuteKey", "DualSense Mute"); },
+			.Flags = GamepadKey, .Source = EDsKeySource::ButtonMap, .ButtonFlag = DS5W_ISTATE_BTN_MIC_BUTTON
+		},
+
+		// DualSenseWindows doesn't define flags for the DualSense Edge buttons. They follow the mute
+		// button in the extra buttons byte, which is placed in the third byte of the buttons map.
+
+		{
+			.Name = TEXT("DsLeftFunction"), .DisplayName = [] { return LOCTEXT("LeftFunctionKey", "DualSense Edge Left Function"); },
+			.Flags = GamepadKey, .Source = EDsKeySource::ButtonMap, .ButtonFlag = 0x100000, .bEdgeOnly = true
+		},
+		{
+			.Name = TEXT("DsRightFunction"), .DisplayName = [] { return LOCTEXT("RightFunctionKey", "DualSense Edge Right Function"); },
+			.Flags = GamepadKey, .Source = EDsKeySource::ButtonMap, .ButtonFlag = 0x200000, .bEdgeOnly = true
+		},
+		{
+			.Name = TEXT("DsLeftPaddle"), .DisplayName = [] { return LOCTEXT("LeftPaddleKey", "DualSense Edge Left Paddle"); },
+			.Flags = GamepadKey, .Source = EDsKeySource::ButtonMap, .ButtonFlag = 0x400000, .bEdgeOnly = true
+		},
+		{
+			.Name = TEXT("DsRightPaddle"), .DisplayName = [] { return LOCTEXT("RightPaddleKey", "DualSense Edge Right Paddle"); },
+			.Flags = GamepadKey, .Source = EDsKeySource::ButtonMap, .ButtonFlag = 0x800000, .bEdgeOnly = true
+		},
+
+		// Touch 1.
+
+		{
+			.Name = TEXT("DsTouch1"), .DisplayName = [] { return LOCTEXT("Touch1Key", "DualSense Touch 1"); },
+			.Flags = TouchKey, .Source = EDsKeySource::Touch1
+		},
+		{
+			.Name = TEXT("DsTouch1AxisX"), .DisplayName = [] { return LOCTEXT("Touch1AxisXKey", "DualSense Touch 1 X-Axis"); },
+			.Flags = TouchAxisKey
+		},
+		{
+			.Name = TEXT("DsTouch1AxisY"), .DisplayName = [] { return LOCTEXT("Touch1AxisYKey", "DualSense Touch 1 Y-Axis"); },
+			.Flags = TouchAxisKey
+		},
+		{
+			.Name = TEXT("DsTouch1AxisXY"), .DisplayName = [] { return LOCTEXT("Touch1AxisXYKey", "DualSense Touch 1 XY-Axis"); },
+			.Flags = TouchPairedAxisKey, .PairedAxisXName = TEXT("DsTouch1AxisX"), .PairedAxisYName = TEXT("DsTouch1AxisY")
+		},
+
+		// Touch 2.
+
+		{
+			.Name = TEXT("DsTouch2"), .DisplayName = [] { return LOCTEXT("Touch2Key", "DualSense Touch 2"); },
+			.Flags = TouchKey, .Source = EDsKeySource::Touch2
+		},
+		{
+			.Name = TEXT("DsTouch2AxisX"), .DisplayName = [] { return LOCTEXT("Touch2AxisXKey", "DualSense Touch 2 X-Axis"); },
+			.Flags = TouchAxisKey
+		},
+		{
+			.Name = TEXT("DsTouch2AxisY"), .DisplayName = [] { return LOCTEXT("Touch2AxisYKey", "DualSense Touch 2 Y-Axis"); },
+			.Flags = TouchAxisKey
+		},
+		{
+			.Name = TEXT("DsTouch2AxisXY"), .DisplayName = [] { return LOCTEXT("Touch2AxisXYKey", "DualSense Touch 2 XY-Axis"); },
+			.Flags = TouchPairedAxisKey, .PairedAxisXName = TEXT("DsTouch2AxisX"), .PairedAxisYName = TEXT("DsTouch2AxisY")
+		},
+
+		// Gyroscope.
+
+		{
+			.Name = TEXT("DsGyroscopeRoll"), .DisplayName = [] { return LOCTEXT("GyroscopeAxisRollKey", "DualSense Gyroscope Roll Axis"); },
+			.Flags = AxisKey
+		},
+		{
+			.Name = TEXT("DsGyroscopePitch"), .DisplayName = [] { return LOCTEXT("GyroscopeAxisPitchKey", "DualSense Gyroscope Pitch Axis"); },
+			.Flags = AxisKey
+		},
+		{
+			.Name = TEXT("DsGyroscopeYaw"), .DisplayName = [] { return LOCTEXT("GyroscopeAxisYawKey", "DualSense Gyroscope Yaw Axis"); },
+			.Flags = AxisKey
+		},
+		{
+			.Name = TEXT("DsGyroscopeYawPitch"),
+			.DisplayName = [] { return LOCTEXT("GyroscopeAxisYawPitchKey", "DualSense Gyroscope Yaw/Pitch Axis"); },
+			.Flags = PairedAxisKey, .PairedAxisXName = TEXT("DsGyroscopeYaw"), .PairedAxisYName = TEXT("DsGyroscopePitch")
+		},
+
+		// Accelerometer.
+
+		{
+			.Name = TEXT("DsAccelerometerX"), .DisplayName = [] { return LOCTEXT("AccelerometerAxisXKey", "DualSense Accelerometer X-Axis"); },
+			.Flags = AbsoluteAxisKey
+		},
+		{
+			.Name = TEXT("DsAccelerometerY"), .DisplayName = [] { return LOCTEXT("AccelerometerAxisYKey", "DualSense Accelerometer Y-Axis"); },
+			.Flags = AbsoluteAxisKey
+		},
+		{
+			.Name = TEXT("DsAccelerometerZ"), .DisplayName = [] { return LOCTEXT("AccelerometerAxisZKey", "DualSense Accelerometer Z-Axis"); },
+			.Flags = AbsoluteAxisKey
+		},
+
+		// Gravity.
+
+		{
+			.Name = TEXT("DsGravityX"), .DisplayName = [] { return LOCTEXT("GravityAxisXKey", "DualSense Gravity X-Axis"); },
+			.Flags = AbsoluteAxisKey
+		},
+		{
+			.Name = TEXT("DsGravityY"), .DisplayName = [] { return LOCTEXT("GravityAxisYKey", "DualSense Gravity Y-Axis"); },
+			.Flags = AbsoluteAxisKey
+		},
+		{
+			.Name = TEXT("DsGravityZ"), .DisplayName = [] { return LOCTEXT("GravityAxisZKey", "DualSense Gravity Z-Axis"); },
+			.Flags = AbsoluteAxisKey
+		},
+
+		// Gyro aim, sent by the gyro aiming once per frame.
+
+		{
+			.Name = TEXT("DsGyroAimX"), .DisplayName = [] { return LOCTEXT("GyroAimAxisXKey", "DualSense Gyro Aim X-Axis"); },
+			.Flags = AxisKey
+		},
+		{
+			.Name = TEXT("DsGyroAimY"), .DisplayName = [] { return LOCTEXT("GyroAimAxisYKey", "DualSense Gyro Aim Y-Axis"); },
+			.Flags = AxisKey
+		},
+		{
+			.Name = TEXT("DsGyroAimXY"), .DisplayName = [] { return LOCTEXT("GyroAimAxisXYKey", "DualSense Gyro Aim XY-Axis"); },
+			.Flags = PairedAxisKey, .PairedAxisXName = TEXT("DsGyroAimX"), .PairedAxisYName = TEXT("DsGyroAimY")
+		},
+
+		// Motion events, sent and released by the motion event detection.
+
+		{
+			.Name = TEXT("DsShake"), .DisplayName = [] { return LOCTEXT("ShakeKey", "DualSense Shake"); },
+			.Flags = GamepadKey
+		},
+		{
+			.Name = TEXT("DsFlickLeft"), .DisplayName = [] { return LOCTEXT("FlickLeftKey", "DualSense Flick Left"); },
+			.Flags = GamepadKey
+		},
+		{
+			.Name = TEXT("DsFlickRight"), .DisplayName = [] { return LOCTEXT("FlickRightKey", "DualSense Flick Right"); },
+			.Flags = GamepadKey
+		},
+		{
+			.Name = TEXT("DsFlickUp"), .DisplayName = [] { return LOCTEXT("FlickUpKey", "DualSense Flick Up"); },
+			.Flags = GamepadKey
+		},
+		{
+			.Name = TEXT("DsFlickDown"), .DisplayName = [] { return LOCTEXT("FlickDownKey", "DualSense Flick Down"); },
+			.Flags = GamepadKey
+		},
+		{
+			.Name = TEXT("DsFaceDown"), .DisplayName = [] { return LOCTEXT("FaceDownKey", "DualSense Face Down"); },
+			.Flags = GamepadKey
+		},
+		{
+			.Name = TEXT("DsUpright"), .DisplayName = [] { return LOCTEXT("UprightKey", "DualSense Upright"); },
+			.Flags = GamepadKey
+		},
+	};
+
+#undef LOCTEXT_NAMESPACE
+
+	inline constexpr int32 KeysCount{UE_ARRAY_COUNT(Descriptors)};
+
+	// Deliberately not constexpr, so that calling it during the compile time evaluation fails the build.
+	inline void OnKeyNotFound() {}
+
+	// Evaluated at compile time only, so that a key missing from the table fails the build.
+	consteval int32 GetKeyIndex(const TCHAR* Name)
+	{
+		for (auto i{0}; i < KeysCount; i++)
+		{
+			auto j{0};
+
+			while (Descriptors[i].Name[j] != TCHAR{0} && Descriptors[i].Name[j] == Name[j])
+			{
+				j++;
+			}
+
+			if (Descriptors[i].Name[j] == Name[j])
+			{
+				return i;
+			}
+		}
+
+		OnKeyNotFound();
+		return INDEX_NONE;
+	}
+
+	// The index of the button among the keys that are buttons, used for the button repeat state.
+	constexpr int32 GetButtonIndex(const int32 KeyIndex)
+	{
+		auto ButtonIndex{0};
+
+		for (auto i{0}; i < KeyIndex; i++)
+		{
+			ButtonIndex += Descriptors[i].Source != EDsKeySource::None ? 1 : 0;
+		}
+
+		return ButtonIndex;
+	}
+
+	inline constexpr auto ButtonsCount{GetButtonIndex(KeysCount)};
+
+	// Names of the keys in the order of the descriptors, created once on startup.
+	FABULOUSDUALSENSE_API const FName& GetName(int32 KeyIndex);
+
+	// Registers the plugin's own keys in the given menu category.
+	FABULOUSDUALSENSE_API void RegisterKeys(const FName& CategoryName);
+
+	// Returns INDEX_NONE if the key isn't handled by the plugin.
+	FABULOUSDUALSENSE_API int32 FindKeyIndex(const FName& KeyName);
+
+	template <int32 KeyIndex>
+	FORCEINLINE bool IsButtonDown(const DS5W::DS5InputState& Input)
+	{
+		constexpr auto& Descriptor{Descriptors[KeyIndex]};
+
+		if constexpr (Descriptor.Source == EDsKeySource::ButtonMap)
+		{
+			return (Input.buttonMap & Descriptor.ButtonFlag) > 0;
+		}
+		else if constexpr (Descriptor.Source == EDsKeySource::LeftStickUp)
+		{
+			return Input.leftStick.y > DsConstants::StickDeadZone;
+		}
+		else if constexpr (Descriptor.Source == EDsKeySource::LeftStickDown)
+		{
+			return Input.leftStick.y < -DsConstants::StickDeadZone;
+		}
+		else if constexpr (Descriptor.Source == EDsKeySource::LeftStickLeft)
+		{
+			return Input.leftStick.x < -DsConstants::StickDeadZone;
+		}
+		else if constexpr (Descriptor.Source == EDsKeySource::LeftStickRight)
+		{
+			return Input.leftStick.x > DsConstants::StickDeadZone;
+		}
+		else if constexpr (Descriptor.Source == EDsKeySource::RightStickUp)
+		{
+			return Input.rightStick.y > DsConstants::StickDeadZone;
+		}
+		else if constexpr (Descriptor.Source == EDsKeySource::RightStickDown)
+		{
+			return Input.rightStick.y < -DsConstants::StickDeadZone;
+		}
+		else if constexpr (Descriptor.Source == EDsKeySource::RightStickLeft)
+		{
+			return Input.rightStick.x < -DsConstants::StickDeadZone;
+		}
+		else if constexpr (Descriptor.Source == EDsKeySource::RightStickRight)
+		{
+			return Input.rightStick.x > DsConstants::StickDeadZone;
+		}
+		else if constexpr (Descriptor.Source == EDsKeySource::Touch1)
+		{
+			return Input.touchPoint1.down;
+		}
+		else if constexpr (Descriptor.Source == EDsKeySource::Touch2)
+		{
+			return Input.touchPoint2.down;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	// Same as DsKeys::IsButtonDown<KeyIndex>(), but for a key index that is only known at runtime, such as one from the settings.
+	FABULOUSDUALSENSE_API bool IsButtonDown(int32 KeyIndex, const DS5W::DS5InputState& Input);
+
+	template <typename FunctionType, int32... KeyIndices>
+	FORCEINLINE void ForEachButton(FunctionType&& Function, TIntegerSequence<int32, KeyIndices...>)
+	{
+		const auto CallForButton{
+			[&Function]<int32 KeyIndex>(TIntegralConstant<int32, KeyIndex> KeyIndexConstant)
+			{
+				if constexpr (Descriptors[KeyIndex].Source != EDsKeySource::None)
+				{
+					Function(KeyIndexConstant);
+				}
+			}
+		};
+
+		(CallForButton(TIntegralConstant<int32, KeyIndices>{}), ...);
+	}
+
+	// Calls the function with a TIntegralConstant of the key index for every button key, fully unrolled at compile time.
+	template <typename FunctionType>
+	FORCEINLINE void ForEachButton(FunctionType&& Function)
+	{
+		ForEachButton(Function, TMakeIntegerSequence<int32, KeysCount>{});
+	}
+}
@@ -0,0 +1,147 @@
+#include "DsLinkQuality.h"
+
+void FDsLinkQualityTracker::Reset()
+{
+	*this = FDsLinkQualityTracker{};
+}
+
+void FDsLinkQualityTracker::Resynchronize()
+{
+	bHasPreviousReport = false;
+}
+
+void FDsLinkQualityTracker::BeginBatch()
+{
+	BatchReportsCount = 0;
+	BatchMissedReportsCount = 0;
+}
+
+void FDsLinkQualityTracker::EndBatch(const bool bBufferOverflowed)
+{
+	if (!bBufferOverflowed || BatchMissedReportsCount <= 0)
+	{
+		return;
+	}
+
+	// Radio losses within the same batch can't be told apart from the overflow, so the whole batch is attributed to it.
+
+	Totals.MissedReportsCount -= BatchMissedReportsCount;
+	Totals.OverflowedReportsCount += BatchMissedReportsCount;
+
+	for (auto i{1}; i <= FMath::Min(BatchReportsCount, WindowReportsCount); i++)
+	{
+		auto& Entry{Window[(WindowIndex - i + WindowSize) % WindowSize]};
+
+		WindowMissedReportsCount -= Entry.MissedReportsCount;
+		Entry.MissedReportsCount = 0;
+	}
+
+	BatchMissedReportsCount = 0;
+}
+
+void FDsLinkQualityTracker::AddReport(const uint8 SequenceNumber, const uint32 SensorTimestamp)
+{
+	static constexpr auto WarmUpReportsCount{32};
+	static constexpr auto TimestampGapThreshold{1.5f};
+
+	Totals.ReceivedReportsCount += 1;
+
+	if (!bHasPreviousReport)
+	{
+		bHasPreviousReport = true;
+		PreviousSequenceNumber = SequenceNumber;
+		PreviousSensorTimestamp = SensorTimestamp;
+
+		PushEntry({});
+		return;
+	}
+
+	// Both the sequence number and the sensor timestamp wrap around, so rely on unsigned arithmetic here.
+
+	const auto SequenceDelta{static_cast<uint8>(SequenceNumber - PreviousSequenceNumber)};
+	const auto TimestampDelta{static_cast<uint32>(SensorTimestamp - PreviousSensorTimestamp)};
+
+	if (SequenceDelta == 0)
+	{
+		Totals.DuplicatedReportsCount += 1;
+
+		PushEntry({});
+		return;
+	}
+
+	FReportEntry Entry;
+
+	Entry.MissedReportsCount = SequenceDelta - 1;
+	Totals.MissedReportsCount += Entry.MissedReportsCount;
+	BatchMissedReportsCount += Entry.MissedReportsCount;
+
+	const auto IntervalUs{TimestampDelta * SensorTimestampToMicroseconds / SequenceDelta};
+
+	if (Totals.ReceivedReportsCount <= WarmUpReportsCount)
+	{
+		// Quickly converge to the actual report interval, since it depends on the connection type.
+
+		ReportIntervalUs = FMath::Lerp(ReportIntervalUs, IntervalUs, 0.25f);
+	}
+	else if (IntervalUs > ReportIntervalUs * TimestampGapThreshold)
+	{
+		Totals.TimestampGapsCount += 1;
+	}
+	else
+	{
+		ReportIntervalUs = FMath::Lerp(ReportIntervalUs, IntervalUs, 0.01f);
+	}
+
+	Entry.IntervalErrorUs = IntervalUs - ReportIntervalUs;
+
+	PreviousSequenceNumber = SequenceNumber;
+	PreviousSensorTimestamp = SensorTimestamp;
+
+	PushEntry(Entry);
+}
+
+void FDsLinkQualityTracker::AddCorruptedReport()
+{
+	Totals.CorruptedReportsCount += 1;
+}
+
+void FDsLinkQualityTracker::GetStatistics(FDsLinkQualityStatistics& Statistics) const
+{
+	Statistics = Totals;
+
+	if (WindowReportsCount <= 0)
+	{
+		return;
+	}
+
+	Statistics.LossRate = static_cast<float>(WindowMissedReportsCount) /
+	                      static_cast<float>(WindowReportsCount + WindowMissedReportsCount);
+
+	Statistics.ReportIntervalMs = ReportIntervalUs * 0.001f;
+
+	Statistics.JitterMs = static_cast<float>(FMath::Sqrt(FMath::Max(0.0, WindowIntervalErrorSquaredSum / WindowReportsCount))) * 0.001f;
+}
+
+void FDsLinkQualityTracker::PushEntry(const FReportEntry& Entry)
+{
+	auto& WindowEntry{Window[WindowIndex]};
+
+	if (WindowReportsCount >= WindowSize)
+	{
+		WindowMissedReportsCount -= WindowEntry.MissedReportsCount;
+		WindowIntervalErrorSquaredSum -= FMath::Square(static_cast<double>(WindowEntry.IntervalErrorUs));
+	}
+	else
+	{
+		WindowReportsCount += 1;
+	}
+
+	WindowEntry = Entry;
+
+	WindowMissedReportsCount += WindowEntry.MissedReportsCount;
+	WindowIntervalErrorSquaredSum += FMath::Square(static_cast<double>(WindowEntry.IntervalErrorUs));
+
+	WindowIndex = (WindowIndex + 1) % WindowSize;
+
+	BatchReportsCount += 1;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "DsStatistics.h"
+
+class FABULOUSDUALSENSE_API FDsLinkQualityTracker
+{
+private:
+	static constexpr auto WindowSize{256};
+
+	// The sensor timestamp is measured in 0.33 microseconds.
+	static constexpr auto SensorTimestampToMicroseconds{1.0f / 3.0f};
+
+	static constexpr auto DefaultReportIntervalUs{4000.0f};
+
+	struct FReportEntry
+	{
+		uint8 MissedReportsCount{0};
+
+		float IntervalErrorUs{0.0f};
+	};
+
+	FReportEntry Window[WindowSize];
+
+	int32 WindowIndex{0};
+
+	int32 WindowReportsCount{0};
+
+	uint32 WindowMissedReportsCount{0};
+
+	double WindowIntervalErrorSquaredSum{0.0};
+
+	float ReportIntervalUs{DefaultReportIntervalUs};
+
+	uint32 PreviousSensorTimestamp{0};
+
+	uint8 PreviousSequenceNumber{0};
+
+	uint8 bHasPreviousReport : 1 {false};
+
+	int32 BatchReportsCount{0};
+
+	uint32 BatchMissedReportsCount{0};
+
+	FDsLinkQualityStatistics Totals;
+
+public:
+	void Reset();
+
+	// Starts tracking from the next report without treating the reports received in the meantime as missed.
+	void Resynchronize();
+
+	// Starts a batch of reports read from the device during one frame.
+	void BeginBatch();
+
+	// If the input buffer of the OS overflowed before the batch was read, the reports it dropped show up as a gap in
+	// the sequence numbers of the batch. The gaps of such a batch are then counted as overflowed instead of missed.
+	void EndBatch(bool bBufferOverflowed);
+
+	void AddReport(uint8 SequenceNumber, uint32 SensorTimestamp);
+
+	void AddCorruptedReport();
+
+	void GetStatistics(FDsLinkQualityStatistics& Statistics) const;
+
+private:
+	void PushEntry(const FReportEntry& Entry);
+};
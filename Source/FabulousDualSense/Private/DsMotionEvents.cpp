@@ -0,0 +1,167 @@
+#include "DsMotionEvents.h"
+
+#include "DsSettings.h"
+
+void FDsMotionEventDetector::Reset()
+{
+	*this = FDsMotionEventDetector{};
+}
+
+void FDsMotionEventDetector::AddSample(const FDsMotionState& Motion, const float DeltaTime, const UDsSettings& Settings)
+{
+	SampleTime += DeltaTime;
+
+	DetectShake(Motion, Settings);
+	DetectFlick(Motion, Settings);
+
+	// The gravity vector points up, so it points along the negative Y axis when the controller is
+	// lying face down, and along the Z axis when the controller is held vertically with the touchpad
+	// facing the player. The orientation is left with a bit of a hysteresis to avoid flickering.
+
+	static constexpr auto HysteresisAngle{10.0f};
+
+	const auto GravityDirection{Motion.Gravity.GetSafeNormal()};
+
+	const auto EnterThreshold{FMath::Cos(FMath::DegreesToRadians(Settings.OrientationAngleThreshold))};
+	const auto LeaveThreshold{FMath::Cos(FMath::DegreesToRadians(Settings.OrientationAngleThreshold + HysteresisAngle))};
+
+	DetectOrientation(EDsMotionEvents::FaceDown, -GravityDirection.Y >= EnterThreshold,
+	                  -GravityDirection.Y < LeaveThreshold, FaceDownStartTime, Settings);
+
+	DetectOrientation(EDsMotionEvents::Upright, FMath::Abs(GravityDirection.Z) >= EnterThreshold,
+	                  FMath::Abs(GravityDirection.Z) < LeaveThreshold, UprightStartTime, Settings);
+}
+
+EDsMotionEvents FDsMotionEventDetector::ConsumeEvents()
+{
+	const auto Events{PendingEvents | ActiveOrientations};
+
+	PendingEvents = EDsMotionEvents::None;
+
+	return Events;
+}
+
+void FDsMotionEventDetector::DetectShake(const FDsMotionState& Motion, const UDsSettings& Settings)
+{
+	// A shake is a series of strong accelerations in alternating directions. The times of the direction reversals
+	// are stored in a ring buffer, so checking whether enough of them happened recently takes constant time.
+
+	const auto LinearAcceleration{Motion.Accelerometer - Motion.Gravity};
+
+	if (LinearAcceleration.SizeSquared() < FMath::Square(Settings.ShakeAccelerationThreshold))
+	{
+		return;
+	}
+
+	const auto Direction{LinearAcceleration.GetSafeNormal()};
+
+	if ((Direction | ShakeDirection) < -0.5f)
+	{
+		ShakeReversalTimes[ShakeReversalIndex] = SampleTime;
+		ShakeReversalIndex = (ShakeReversalIndex + 1) % MaxShakeReversalsCount;
+		ShakeReversalsCount = FMath::Min(ShakeReversalsCount + 1, MaxShakeReversalsCount);
+
+		const auto RequiredReversalsCount{FMath::Clamp(Settings.ShakeReversalsCount, 1, MaxShakeReversalsCount)};
+
+		if (ShakeReversalsCount >= RequiredReversalsCount)
+		{
+			const auto OldestReversalIndex{
+				(ShakeReversalIndex - RequiredReversalsCount + MaxShakeReversalsCount) % MaxShakeReversalsCount
+			};
+
+			if (SampleTime - ShakeReversalTimes[OldestReversalIndex] <= Settings.ShakeDuration)
+			{
+				PendingEvents |= EDsMotionEvents::Shake;
+
+				// Start over, so that a long shake isn't reported on every reversal.
+
+				ShakeReversalsCount = 0;
+			}
+		}
+	}
+
+	ShakeDirection = Direction;
+}
+
+void FDsMotionEventDetector::DetectFlick(const FDsMotionState& Motion, const UDsSettings& Settings)
+{
+	// A flick is a short burst of rotation around the yaw or pitch axis. Slower or longer
+	// rotations are regular aiming or turning, so they are ignored. Positive angular velocities
+	// follow the right-hand rule, so the positive yaw is a turn to the left and the
+	// positive pitch is a tilt of the front edge of the controller upwards.
+
+	const FVector2f AngularVelocity{Motion.Gyroscope.X, Motion.Gyroscope.Y};
+	const auto Magnitude{AngularVelocity.GetAbsMax()};
+
+	if (!bFlickActive)
+	{
+		if (Magnitude >= Settings.FlickAngularVelocityThreshold)
+		{
+			bFlickActive = true;
+			FlickStartTime = SampleTime;
+			FlickPeak = AngularVelocity;
+		}
+
+		return;
+	}
+
+	if (Magnitude > FlickPeak.GetAbsMax())
+	{
+		FlickPeak = AngularVelocity;
+	}
+
+	if (Magnitude >= Settings.FlickAngularVelocityThreshold * 0.5f)
+	{
+		return;
+	}
+
+	bFlickActive = false;
+
+	if (SampleTime - FlickStartTime > Settings.FlickMaxDuration)
+	{
+		return;
+	}
+
+	if (FMath::Abs(FlickPeak.Y) >= FMath::Abs(FlickPeak.X))
+	{
+		PendingEvents |= FlickPeak.Y > 0.0f ? EDsMotionEvents::FlickLeft : EDsMotionEvents::FlickRight;
+	}
+	else
+	{
+		PendingEvents |= FlickPeak.X > 0.0f ? EDsMotionEvents::FlickUp : EDsMotionEvents::FlickDown;
+	}
+}
+
+void FDsMotionEventDetector::DetectOrientation(const EDsMotionEvents Orientation, const bool bInside, const bool bOutside,
+                                               double& StartTime, const UDsSettings& Settings)
+{
+	if (EnumHasAnyFlags(ActiveOrientations, Orientation))
+	{
+		if (bOutside)
+		{
+			EnumRemoveFlags(ActiveOrientations, Orientation);
+			EnumRemoveFlags(CandidateOrientations, Orientation);
+		}
+
+		return;
+	}
+
+	if (!bInside)
+	{
+		EnumRemoveFlags(CandidateOrientations, Orientation);
+		return;
+	}
+
+	// The orientation must be held for some time, otherwise it is most likely just a part of a movement.
+
+	if (!EnumHasAnyFlags(CandidateOrientations, Orientation))
+	{
+		CandidateOrientations |= Orientation;
+		StartTime = SampleTime;
+	}
+
+	if (SampleTime - StartTime >= Settings.OrientationHoldTime)
+	{
+		ActiveOrientations |= Orientation;
+	}
+}
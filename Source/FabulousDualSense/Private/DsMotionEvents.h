@@ -0,0 +1,78 @@
+#pragma once
+
+#include "DsImuCalibration.h"
+
+class UDsSettings;
+
+enum class EDsMotionEvents : uint8
+{
+	None = 0,
+	Shake = 1 << 0,
+	FlickLeft = 1 << 1,
+	FlickRight = 1 << 2,
+	FlickUp = 1 << 3,
+	FlickDown = 1 << 4,
+	FaceDown = 1 << 5,
+	Upright = 1 << 6,
+
+	// Events that are reported once, as opposed to orientations that are reported for as long as they last.
+	Pulses = Shake | FlickLeft | FlickRight | FlickUp | FlickDown
+};
+
+ENUM_CLASS_FLAGS(EDsMotionEvents)
+
+class FABULOUSDUALSENSE_API FDsMotionEventDetector
+{
+private:
+	static constexpr auto MaxShakeReversalsCount{16};
+
+	// Sensor time accumulated from the report timestamps.
+	double SampleTime{0.0};
+
+	// Shake.
+
+	double ShakeReversalTimes[MaxShakeReversalsCount]{};
+
+	int32 ShakeReversalIndex{0};
+
+	int32 ShakeReversalsCount{0};
+
+	FVector3f ShakeDirection{ForceInit};
+
+	// Flick.
+
+	double FlickStartTime{0.0};
+
+	// Signed peak angular velocity of the current flick, the X component is the pitch and the Y component is the yaw.
+	FVector2f FlickPeak{ForceInit};
+
+	uint8 bFlickActive : 1 {false};
+
+	// Orientation.
+
+	double FaceDownStartTime{0.0};
+
+	double UprightStartTime{0.0};
+
+	EDsMotionEvents ActiveOrientations{EDsMotionEvents::None};
+
+	EDsMotionEvents CandidateOrientations{EDsMotionEvents::None};
+
+	EDsMotionEvents PendingEvents{EDsMotionEvents::None};
+
+public:
+	void Reset();
+
+	// Runs in constant time, so it can be called for every report.
+	void AddSample(const FDsMotionState& Motion, float DeltaTime, const UDsSettings& Settings);
+
+	// Returns the events detected since the previous call along with the current orientations.
+	EDsMotionEvents ConsumeEvents();
+
+private:
+	void DetectShake(const FDsMotionState& Motion, const UDsSettings& Settings);
+
+	void DetectFlick(const FDsMotionState& Motion, const UDsSettings& Settings);
+
+	void DetectOrientation(EDsMotionEvents Orientation, bool bInside, bool bOutside, double& StartTime, const UDsSettings& Settings);
+};
@@ -0,0 +1,103 @@
+#include "DsRawReports.h"
+
+#include <DualSenseWindows.h>
+
+#include "DsRawReportsPublisher.h"
+#include "Templates/Function.h"
+
+namespace DsRawReports
+{
+	// About 2 seconds of reports from four controllers at 250 Hz.
+	static constexpr auto RingSize{2048};
+
+	static_assert(FMath::IsPowerOfTwo(RingSize));
+
+	struct FSlot
+	{
+		double Time{0.0};
+
+		int32 ControllerId{INDEX_NONE};
+
+		int32 ReportSize{0};
+
+		uint8 Report[DS_MAX_INPUT_REPORT_SIZE]{};
+	};
+
+	FSlot Slots[RingSize];
+
+	uint64 PublishedReportsCount{0};
+
+	int32 ReadersCount{0};
+}
+
+void DsRawReports::Publish(const int32 ControllerId, const double Time, const uint8* Report, const int32 ReportSize)
+{
+	check(IsInGameThread());
+
+	if (ReadersCount <= 0)
+	{
+		return;
+	}
+
+	auto& Slot{Slots[PublishedReportsCount & (RingSize - 1)]};
+
+	Slot.Time = Time;
+	Slot.ControllerId = ControllerId;
+	Slot.ReportSize = FMath::Min(ReportSize, static_cast<int32>(UE_ARRAY_COUNT(Slot.Report)));
+
+	FMemory::Memcpy(Slot.Report, Report, Slot.ReportSize);
+
+	PublishedReportsCount += 1;
+}
+
+FDsRawReportReader::FDsRawReportReader() : NextSequenceNumber{DsRawReports::PublishedReportsCount}
+{
+	check(IsInGameThread());
+
+	DsRawReports::ReadersCount += 1;
+}
+
+FDsRawReportReader::~FDsRawReportReader()
+{
+	check(IsInGameThread());
+
+	DsRawReports::ReadersCount -= 1;
+}
+
+uint64 FDsRawReportReader::Read(const TFunctionRef<void(const FDsRawReport& Report)> Visitor)
+{
+	check(IsInGameThread());
+
+	const auto PublishedReportsCount{DsRawReports::PublishedReportsCount};
+
+	uint64 NewMissedReportsCount{0};
+
+	if (PublishedReportsCount - NextSequenceNumber > DsRawReports::RingSize)
+	{
+		NewMissedReportsCount = PublishedReportsCount - NextSequenceNumber - DsRawReports::RingSize;
+		NextSequenceNumber = PublishedReportsCount - DsRawReports::RingSize;
+
+		MissedReportsCount += NewMissedReportsCount;
+	}
+
+	FDsRawReport Report;
+
+	for (; NextSequenceNumber < PublishedReportsCount; NextSequenceNumber++)
+	{
+		const auto& Slot{DsRawReports::Slots[NextSequenceNumber & (DsRawReports::RingSize - 1)]};
+
+		Report.SequenceNumber = NextSequenceNumber;
+		Report.Time = Slot.Time;
+		Report.ControllerId = Slot.ControllerId;
+		Report.Data = MakeArrayView(Slot.Report, Slot.ReportSize);
+
+		Visitor(Report);
+	}
+
+	return NewMissedReportsCount;
+}
+
+uint64 FDsRawReportReader::GetMissedReportsCount() const
+{
+	return MissedReportsCount;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "DsRawReports.h"
+
+namespace DsRawReports
+{
+	// Must only be called from the game thread. Does nothing if there are no readers.
+	void Publish(int32 ControllerId, double Time, const uint8* Report, int32 ReportSize);
+}
@@ -0,0 +1,56 @@
+#include "DsReconnection.h"
+
+#include "DsSettings.h"
+
+void FDsReconnectionTracker::Start(const double Time, const UDsSettings& Settings)
+{
+	*this = FDsReconnectionTracker{};
+
+	bReconnecting = true;
+	Delay = Settings.ReconnectInitialDelay;
+
+	ScheduleAttempt(Time);
+}
+
+void FDsReconnectionTracker::Stop()
+{
+	bReconnecting = false;
+}
+
+bool FDsReconnectionTracker::IsReconnecting() const
+{
+	return bReconnecting;
+}
+
+bool FDsReconnectionTracker::ShouldAttempt(const double Time) const
+{
+	return bReconnecting && Time >= NextAttemptTime;
+}
+
+int32 FDsReconnectionTracker::GetFailedAttemptsCount() const
+{
+	return FailedAttemptsCount;
+}
+
+bool FDsReconnectionTracker::AddFailedAttempt(const double Time, const UDsSettings& Settings)
+{
+	FailedAttemptsCount += 1;
+
+	if (FailedAttemptsCount >= Settings.ReconnectAttemptsCount)
+	{
+		return false;
+	}
+
+	Delay = FMath::Min(Delay * 2.0f, Settings.ReconnectMaxDelay);
+
+	ScheduleAttempt(Time);
+	return true;
+}
+
+void FDsReconnectionTracker::ScheduleAttempt(const double Time)
+{
+	// The jitter keeps several controllers that dropped out at the same time,
+	// for example because of Bluetooth interference, from retrying in lockstep.
+
+	NextAttemptTime = Time + Delay * FMath::FRandRange(0.5f, 1.0f);
+}
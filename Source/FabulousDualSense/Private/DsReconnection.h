@@ -0,0 +1,33 @@
+#pragma once
+
+class UDsSettings;
+
+// Schedules reconnectDevice() attempts for a controller that stopped responding, with exponential backoff and jitter.
+class FABULOUSDUALSENSE_API FDsReconnectionTracker
+{
+private:
+	double NextAttemptTime{0.0};
+
+	float Delay{0.0f};
+
+	int32 FailedAttemptsCount{0};
+
+	uint8 bReconnecting : 1 {false};
+
+public:
+	void Start(double Time, const UDsSettings& Settings);
+
+	void Stop();
+
+	bool IsReconnecting() const;
+
+	bool ShouldAttempt(double Time) const;
+
+	int32 GetFailedAttemptsCount() const;
+
+	// Returns false if there are no attempts left.
+	bool AddFailedAttempt(double Time, const UDsSettings& Settings);
+
+private:
+	void ScheduleAttempt(double Time);
+};
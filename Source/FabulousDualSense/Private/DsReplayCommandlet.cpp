@@ -0,0 +1,126 @@
+#include "DsReplayCommandlet.h"
+
+#include "DsInputDevice.h"
+#include "DsUtility.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(DsReplayCommandlet)
+
+UDsReplayCommandlet::UDsReplayCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Replays a DualSense input capture and reports the input path timings.");
+	HelpUsage = TEXT("-run=DsReplay -Capture=<File> [-Report=<File>] [-RealTime] [-Loops=<Count>] [-FrameRate=<Hz>] ")
+		TEXT("[-MaxNsPerReport=<Nanoseconds>] [-MaxAllocations=<Count>]");
+}
+
+int32 UDsReplayCommandlet::Main(const FString& Parameters)
+{
+	FString CaptureFilePath;
+	if (!FParse::Value(*Parameters, TEXT("Capture="), CaptureFilePath))
+	{
+		UE_LOG(LogFabulousDualSense, Error, TEXT("Usage: %s"), *HelpUsage);
+		return 1;
+	}
+
+	auto ReportFilePath{FPaths::ProjectSavedDir() / TEXT("FabulousDualSense") / TEXT("ReplayReport.json")};
+	FParse::Value(*Parameters, TEXT("Report="), ReportFilePath);
+
+	FDsReplayOptions Options;
+	Options.bRealTime = FParse::Param(*Parameters, TEXT("RealTime"));
+	FParse::Value(*Parameters, TEXT("Loops="), Options.LoopsCount);
+	FParse::Value(*Parameters, TEXT("FrameRate="), Options.FrameRate);
+
+	auto MaxNsPerReport{-1.0};
+	FParse::Value(*Parameters, TEXT("MaxNsPerReport="), MaxNsPerReport);
+
+	int64 MaxAllocationsCount{-1};
+	FParse::Value(*Parameters, TEXT("MaxAllocations="), MaxAllocationsCount);
+
+	FDsInputCapture Capture;
+	if (!Capture.LoadFromFile(CaptureFilePath))
+	{
+		UE_LOG(LogFabulousDualSense, Error, TEXT("Failed to load input capture: %s."), *CaptureFilePath);
+		return 1;
+	}
+
+	// The replay uses its own input device without device discovery, so that real controllers are neither
+	// opened nor able to block the replay, and the results don't depend on the engine ticking the device.
+
+	const auto InputDevice{MakeShared<FDsInputDevice>(MakeShared<FGenericApplicationMessageHandler>(), false)};
+
+	FDsReplayResults Results;
+	if (!InputDevice->ReplayCapture(*GLog, Capture, Options, Results))
+	{
+		return 1;
+	}
+
+	const auto ReportsCount{static_cast<double>(FMath::Max<int64>(1, Results.ReportsCount))};
+	const auto EventsCount{Results.AnalogEventsCount + Results.ButtonEventsCount + Results.MouseEventsCount};
+	const auto InputPathTime{Results.ReportProcessingTime + Results.EventDispatchTime + Results.OutputTime};
+	const auto NsPerReport{InputPathTime * 1000000000.0 / ReportsCount};
+
+	FString Report;
+
+	const auto Writer{TJsonWriterFactory<>::Create(&Report)};
+
+	Writer->WriteObjectStart();
+
+	Writer->WriteValue(TEXT("capture"), CaptureFilePath);
+	Writer->WriteValue(TEXT("realTime"), Options.bRealTime);
+	Writer->WriteValue(TEXT("loops"), Options.LoopsCount);
+	Writer->WriteValue(TEXT("frameRate"), Options.FrameRate);
+
+	Writer->WriteValue(TEXT("frames"), Results.FramesCount);
+	Writer->WriteValue(TEXT("reports"), Results.ReportsCount);
+	Writer->WriteValue(TEXT("analogEvents"), Results.AnalogEventsCount);
+	Writer->WriteValue(TEXT("buttonEvents"), Results.ButtonEventsCount);
+	Writer->WriteValue(TEXT("mouseEvents"), Results.MouseEventsCount);
+	Writer->WriteValue(TEXT("allocations"), Results.AllocationsCount);
+
+	Writer->WriteValue(TEXT("elapsedSeconds"), Results.ElapsedTime);
+	Writer->WriteValue(TEXT("eventsPerSecond"), Results.ElapsedTime > 0.0 ? EventsCount / Results.ElapsedTime : 0.0);
+	Writer->WriteValue(TEXT("nsPerReport"), NsPerReport);
+
+	Writer->WriteObjectStart(TEXT("nsPerReportByStage"));
+	Writer->WriteValue(TEXT("reportProcessing"), Results.ReportProcessingTime * 1000000000.0 / ReportsCount);
+	Writer->WriteValue(TEXT("eventDispatch"), Results.EventDispatchTime * 1000000000.0 / ReportsCount);
+	Writer->WriteValue(TEXT("output"), Results.OutputTime * 1000000000.0 / ReportsCount);
+	Writer->WriteObjectEnd();
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	UE_LOG(LogFabulousDualSense, Display, TEXT("%s"), *Report);
+
+	if (!FFileHelper::SaveStringToFile(Report, *ReportFilePath))
+	{
+		UE_LOG(LogFabulousDualSense, Error, TEXT("Failed to save replay report: %s."), *ReportFilePath);
+		return 1;
+	}
+
+	auto ExitCode{0};
+
+	if (MaxNsPerReport >= 0.0 && NsPerReport > MaxNsPerReport)
+	{
+		UE_LOG(LogFabulousDualSense, Error, TEXT("Input path is too slow: %.1f ns per report, the limit is %.1f ns."),
+		       NsPerReport, MaxNsPerReport);
+		ExitCode = 1;
+	}
+
+	if (MaxAllocationsCount >= 0 && Results.AllocationsCount > MaxAllocationsCount)
+	{
+		UE_LOG(LogFabulousDualSense, Error, TEXT("Input path allocates too much: %lld allocations, the limit is %lld."),
+		       Results.AllocationsCount, MaxAllocationsCount);
+		ExitCode = 1;
+	}
+
+	return ExitCode;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "DsReplayCommandlet.generated.h"
+
+// Replays an input capture through a simulated device and writes a JSON report with the input path timings, so that
+// input performance can be checked without controllers, for example on build machines. Returns a non-zero exit code
+// if the replay fails or exceeds one of the given limits.
+//
+// Usage: -run=DsReplay -Capture=<File> [-Report=<File>] [-RealTime] [-Loops=<Count>] [-FrameRate=<Hz>]
+//        [-MaxNsPerReport=<Nanoseconds>] [-MaxAllocations=<Count>]
+UCLASS()
+class UDsReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UDsReplayCommandlet();
+
+	virtual int32 Main(const FString& Parameters) override;
+};
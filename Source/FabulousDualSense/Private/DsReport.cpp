@@ -0,0 +1,38 @@
+#include "DsReport.h"
+
+#include "Misc/Crc.h"
+
+uint32 DsReport::CalculateBluetoothCrc(const uint8 Seed, const uint8* Report, const int32 ReportSize)
+{
+	// FCrc::MemCrc32() uses the slicing-by-8 algorithm, so there is no need for a custom implementation.
+
+	static const uint32 InputSeedCrc{FCrc::MemCrc32(&InputReportCrcSeed, sizeof(InputReportCrcSeed))};
+	static const uint32 OutputSeedCrc{FCrc::MemCrc32(&OutputReportCrcSeed, sizeof(OutputReportCrcSeed))};
+
+	const auto SeedCrc{
+		Seed == InputReportCrcSeed
+			? InputSeedCrc
+			: Seed == OutputReportCrcSeed
+			? OutputSeedCrc
+			: FCrc::MemCrc32(&Seed, sizeof(Seed))
+	};
+
+	return FCrc::MemCrc32(Report, ReportSize - CrcSize, SeedCrc);
+}
+
+bool DsReport::IsBluetoothReportValid(const uint8 Seed, const uint8* Report, const int32 ReportSize)
+{
+	return CalculateBluetoothCrc(Seed, Report, ReportSize) == ReadUInt32(Report + ReportSize - CrcSize);
+}
+
+void DsReport::StampBluetoothReport(const uint8 Seed, uint8* Report, const int32 ReportSize)
+{
+	const auto Crc{CalculateBluetoothCrc(Seed, Report, ReportSize)};
+
+	auto* CrcData{Report + ReportSize - CrcSize};
+
+	CrcData[0] = static_cast<uint8>(Crc);
+	CrcData[1] = static_cast<uint8>(Crc >> 8);
+	CrcData[2] = static_cast<uint8>(Crc >> 16);
+	CrcData[3] = static_cast<uint8>(Crc >> 24);
+}
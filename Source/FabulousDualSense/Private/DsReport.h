@@ -0,0 +1,41 @@
+#pragma once
+
+namespace DsReport
+{
+	// The sensor timestamp is measured in 0.33 microseconds.
+	inline constexpr auto SensorTimestampFrequency{3000000.0f};
+
+	// Bluetooth reports are protected with a CRC32 that is calculated over the
+	// report with an additional seed byte prepended, which depends on the report type.
+
+	inline constexpr uint8 InputReportCrcSeed{0xA1};
+	inline constexpr uint8 OutputReportCrcSeed{0xA2};
+
+	inline constexpr auto CrcSize{4};
+
+	// Report fields are little-endian and not necessarily aligned.
+
+	FORCEINLINE uint16 ReadUInt16(const uint8* Data)
+	{
+		return static_cast<uint16>(static_cast<uint16>(Data[0]) | static_cast<uint16>(Data[1]) << 8);
+	}
+
+	FORCEINLINE int16 ReadInt16(const uint8* Data)
+	{
+		return static_cast<int16>(ReadUInt16(Data));
+	}
+
+	FORCEINLINE uint32 ReadUInt32(const uint8* Data)
+	{
+		return static_cast<uint32>(Data[0]) |
+		       static_cast<uint32>(Data[1]) << 8 |
+		       static_cast<uint32>(Data[2]) << 16 |
+		       static_cast<uint32>(Data[3]) << 24;
+	}
+
+	FABULOUSDUALSENSE_API uint32 CalculateBluetoothCrc(uint8 Seed, const uint8* Report, int32 ReportSize);
+
+	FABULOUSDUALSENSE_API bool IsBluetoothReportValid(uint8 Seed, const uint8* Report, int32 ReportSize);
+
+	FABULOUSDUALSENSE_API void StampBluetoothReport(uint8 Seed, uint8* Report, int32 ReportSize);
+}
@@ -0,0 +1,138 @@
+#include "DsSimulatedDevice.h"
+
+#include "DsInputCapture.h"
+
+void FDsSimulatedDevice::InitializeContext(DS5W::DeviceContext& Context, const uint32 UniqueId) const
+{
+	FMemory::Memzero(Context);
+
+	FCString::Strncpy(Context._internal.devicePath, TEXT("Simulated"), UE_ARRAY_COUNT(Context._internal.devicePath));
+
+	Context._internal.uniqueID = UniqueId;
+	Context._internal.deviceHandle = INVALID_HANDLE_VALUE;
+	Context._internal.connectionType = GetBinding().Connection;
+	Context._internal.connected = true;
+
+	// Raw values are passed through unchanged.
+
+	for (auto& Axis : Context._internal.calibrationData.gyroscope)
+	{
+		Axis = {0, 1, 1};
+	}
+
+	for (auto& Axis : Context._internal.calibrationData.accelerometer)
+	{
+		Axis = {0, 1, 1};
+	}
+}
+
+const FDsDeviceModelBinding& FDsSimulatedDevice::GetBinding() const
+{
+	return Capture != nullptr
+		       ? DsDeviceModels::GetBinding(Capture->Model, Capture->Connection)
+		       : DsDeviceModels::GetBinding(EDsDeviceModel::DualSense, DS5W::DeviceConnection::USB);
+}
+
+void FDsSimulatedDevice::WriteInputReport(uint8* Report)
+{
+	using FDescriptor = FDsDualSenseDescriptor;
+
+	const auto WriteInt16{
+		[](uint8* Data, const int32 Value)
+		{
+			Data[0] = static_cast<uint8>(Value);
+			Data[1] = static_cast<uint8>(Value >> 8);
+		}
+	};
+
+	FMemory::Memzero(Report, FDescriptor::UsbInputReportSize);
+
+	Report[0] = FDescriptor::UsbInputReportId;
+
+	auto* ReportBody{Report + FDescriptor::UsbReportBodyOffset};
+
+	const auto Wave{bActive ? FMath::Sin(static_cast<float>(ReportIndex) * 0.05f) : 0.0f};
+
+	const auto StickValue{static_cast<uint8>(128 + FMath::RoundToInt(Wave * 100.0f))};
+
+	ReportBody[FDescriptor::LeftStickOffset] = StickValue;
+	ReportBody[FDescriptor::LeftStickOffset + 1] = 128;
+	ReportBody[FDescriptor::RightStickOffset] = 128;
+	ReportBody[FDescriptor::RightStickOffset + 1] = StickValue;
+
+	if (bActive && bHoldAnalogInputs)
+	{
+		ReportBody[FDescriptor::LeftStickOffset] = 228;
+		ReportBody[FDescriptor::RightStickOffset + 1] = 28;
+		ReportBody[FDescriptor::LeftTriggerOffset] = 200;
+		ReportBody[FDescriptor::RightTriggerOffset] = 200;
+	}
+
+	ReportBody[FDescriptor::SequenceNumberOffset] = static_cast<uint8>(ReportIndex);
+
+	// The D-pad is released, the cross button is toggled every 16 reports while active.
+
+	ReportBody[FDescriptor::ButtonsOffset] = 0x08 | (bActive && (ReportIndex & 0x10) != 0 ? 0x20 : 0x00);
+
+	auto* ImuData{ReportBody + FDescriptor::ImuOffset};
+
+	WriteInt16(ImuData + 0, FMath::RoundToInt(Wave * 30.0f * DS_GYRO_RES_PER_DEG_S));
+	WriteInt16(ImuData + 2, FMath::RoundToInt(Wave * 10.0f * DS_GYRO_RES_PER_DEG_S));
+	WriteInt16(ImuData + 4, 0);
+	WriteInt16(ImuData + 6, 0);
+	WriteInt16(ImuData + 8, DS_ACC_RES_PER_G);
+	WriteInt16(ImuData + 10, 0);
+
+	// 4 milliseconds in 0.33 microseconds.
+
+	SensorTimestamp += 12000;
+
+	auto* SensorTimestampData{ReportBody + FDescriptor::SensorTimestampOffset};
+
+	SensorTimestampData[0] = static_cast<uint8>(SensorTimestamp);
+	SensorTimestampData[1] = static_cast<uint8>(SensorTimestamp >> 8);
+	SensorTimestampData[2] = static_cast<uint8>(SensorTimestamp >> 16);
+	SensorTimestampData[3] = static_cast<uint8>(SensorTimestamp >> 24);
+
+	// Both touch points are released.
+
+	ReportBody[FDescriptor::TouchPoint1Offset] = 0x80;
+	ReportBody[FDescriptor::TouchPoint2Offset] = 0x80;
+
+	ReportBody[FDescriptor::StatusOffset] = 8;
+
+	ReportIndex += 1;
+}
+
+void FDsSimulatedDevice::StartReplay(const FDsInputCapture& NewCapture, const double StartTime)
+{
+	Capture = &NewCapture;
+	CaptureReportIndex = 0;
+	CaptureStartTime = StartTime;
+}
+
+bool FDsSimulatedDevice::IsReplaying() const
+{
+	return Capture != nullptr;
+}
+
+bool FDsSimulatedDevice::IsReplayFinished() const
+{
+	return Capture != nullptr && CaptureReportIndex >= Capture->GetReportsCount();
+}
+
+bool FDsSimulatedDevice::ReadCapturedReport(const double Time, uint8* Report)
+{
+	if (Capture == nullptr || CaptureReportIndex >= Capture->GetReportsCount() ||
+	    CaptureStartTime + Capture->GetReport(CaptureReportIndex).Time > Time)
+	{
+		return false;
+	}
+
+	const auto Data{Capture->GetReportData(CaptureReportIndex)};
+
+	FMemory::Memcpy(Report, Data.GetData(), Data.Num());
+
+	CaptureReportIndex += 1;
+	return true;
+}
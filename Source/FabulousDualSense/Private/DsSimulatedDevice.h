@@ -0,0 +1,55 @@
+#pragma once
+
+#include <DualSenseWindows.h>
+
+#include "DsDeviceModels.h"
+
+class FDsInputCapture;
+
+// Device that exists only in memory and produces DualSense USB input reports instead of
+// reading them from hardware, so that the input path can be exercised without a controller.
+class FABULOUSDUALSENSE_API FDsSimulatedDevice
+{
+private:
+	uint32 ReportIndex{0};
+
+	uint32 SensorTimestamp{0};
+
+	const FDsInputCapture* Capture{nullptr};
+
+	int32 CaptureReportIndex{0};
+
+	double CaptureStartTime{0.0};
+
+public:
+	// Similar to a 250 Hz device at 60 FPS.
+	int32 ReportsPerFrame{4};
+
+	// Whether the sticks, the gyroscope and the buttons are moving.
+	uint8 bActive : 1 {false};
+
+	// Whether the sticks and the triggers are held still outside of the dead zone while active, instead of moving.
+	uint8 bHoldAnalogInputs : 1 {false};
+
+	// Whether reading input reports fails, which disconnects the device.
+	uint8 bFailReads : 1 {false};
+
+public:
+	void InitializeContext(DS5W::DeviceContext& Context, uint32 UniqueId) const;
+
+	// Generated reports are always DualSense USB reports, captured reports match the device model and the connection of the capture.
+	const FDsDeviceModelBinding& GetBinding() const;
+
+	void WriteInputReport(uint8* Report);
+
+	// Replays the reports of the capture instead of generating them. Each report becomes available once the given start
+	// time plus its capture time is reached. Must be called before the device is connected, the capture must outlive it.
+	void StartReplay(const FDsInputCapture& NewCapture, double StartTime);
+
+	bool IsReplaying() const;
+
+	bool IsReplayFinished() const;
+
+	// Writes the next captured report that is due at the given time. Returns false if there is none.
+	bool ReadCapturedReport(double Time, uint8* Report);
+};
@@ -0,0 +1,25 @@
+#include "DsStatistics.h"
+
+#include "DsInputDevice.h"
+#include "FabulousDualSenseModule.h"
+
+bool DsStatistics::GetLinkQuality(const int32 ControllerId, FDsLinkQualityStatistics& Statistics)
+{
+	const auto InputDevice{FFabulousDualSenseModule::GetInputDevice()};
+
+	return InputDevice.IsValid() && InputDevice->GetLinkQuality(ControllerId, Statistics);
+}
+
+bool DsStatistics::GetPolling(const int32 ControllerId, FDsPollingStatistics& Statistics)
+{
+	const auto InputDevice{FFabulousDualSenseModule::GetInputDevice()};
+
+	return InputDevice.IsValid() && InputDevice->GetPolling(ControllerId, Statistics);
+}
+
+bool DsStatistics::GetIo(const int32 ControllerId, FDsIoStatistics& Statistics)
+{
+	const auto InputDevice{FFabulousDualSenseModule::GetInputDevice()};
+
+	return InputDevice.IsValid() && InputDevice->GetIo(ControllerId, Statistics);
+}
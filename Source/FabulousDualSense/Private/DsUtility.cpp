@@ -44,3 +44,20 @@ constexpr FStringView DsUtility::DeviceConnectionToString(const DS5W::DeviceConn
 
 	return Strings[static_cast<uint8>(DeviceConnection)];
 }
+
+constexpr FStringView DsUtility::DeviceModelToString(const EDsDeviceModel DeviceModel)
+{
+	if (DeviceModel > EDsDeviceModel::DualShock4)
+	{
+		return TEXTVIEW("Unknown device model");
+	}
+
+	static constexpr FStringView Strings[]
+	{
+		TEXTVIEW("DualSense"),
+		TEXTVIEW("DualSense Edge"),
+		TEXTVIEW("DualShock 4")
+	};
+
+	return Strings[static_cast<uint8>(DeviceModel)];
+}
@@ -2,6 +2,7 @@
 
 #include <DualSenseWindows.h>
 
+#include "DsDeviceModels.h"
 #include "Logging/LogMacros.h"
 
 FABULOUSDUALSENSE_API DECLARE_LOG_CATEGORY_EXTERN(LogFabulousDualSense, Log, All)
@@ -11,4 +12,6 @@ namespace DsUtility
 	FABULOUSDUALSENSE_API constexpr FStringView ReturnValueToString(DS5W_ReturnValue ReturnValue);
 
 	FABULOUSDUALSENSE_API constexpr FStringView DeviceConnectionToString(DS5W::DeviceConnection DeviceConnection);
+
+	FABULOUSDUALSENSE_API constexpr FStringView DeviceModelToString(EDsDeviceModel DeviceModel);
 }
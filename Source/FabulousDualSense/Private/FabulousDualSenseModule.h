@@ -2,10 +2,27 @@
 
 #include "IInputDeviceModule.h"
 
+class FDsInputDevice;
+class FDsGyroLateLatchingViewExtension;
+
 class FABULOUSDUALSENSE_API FFabulousDualSenseModule : public IInputDeviceModule
 {
+private:
+	TWeakPtr<FDsInputDevice> InputDevice;
+
+	TSharedPtr<FDsGyroLateLatchingViewExtension, ESPMode::ThreadSafe> GyroLateLatchingViewExtension;
+
+	uint8 bDiagnosticsPanelRegistered : 1 {false};
+
 public:
 	virtual void StartupModule() override;
 
+	virtual void ShutdownModule() override;
+
 	virtual TSharedPtr<IInputDevice> CreateInputDevice(const TSharedRef<FGenericApplicationMessageHandler>& MessageHandler) override;
+
+	static TSharedPtr<FDsInputDevice> GetInputDevice();
+
+private:
+	void OnPostEngineInit();
 };
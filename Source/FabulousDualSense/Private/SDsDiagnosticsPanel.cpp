@@ -0,0 +1,160 @@
+#include "SDsDiagnosticsPanel.h"
+
+#include "DsInputSnapshot.h"
+#include "Framework/Docking/TabManager.h"
+#include "Styling/CoreStyle.h"
+#include "Widgets/Docking/SDockTab.h"
+#include "Widgets/Layout/SScrollBox.h"
+#include "Widgets/Text/STextBlock.h"
+
+#define LOCTEXT_NAMESPACE "SDsDiagnosticsPanel"
+
+namespace DsDiagnosticsPanel
+{
+	static const FName TabName{TEXTVIEW("DualSenseDiagnostics")};
+
+	static constexpr auto RefreshInterval{0.5f};
+}
+
+void SDsDiagnosticsPanel::Construct(const FArguments& Arguments)
+{
+	const auto Font{FCoreStyle::GetDefaultFontStyle(FName{TEXTVIEW("Mono")}, 9)};
+
+	const auto ScrollBox{SNew(SScrollBox)};
+
+	for (auto& DeviceText : DeviceTexts)
+	{
+		ScrollBox->AddSlot()
+		         .Padding(8.0f, 4.0f)
+		[
+			SAssignNew(DeviceText, STextBlock)
+			.Font(Font)
+		];
+	}
+
+	ChildSlot
+	[
+		ScrollBox
+	];
+
+	Refresh(FSlateApplication::Get().GetCurrentTime(), 0.0f);
+
+	RegisterActiveTimer(DsDiagnosticsPanel::RefreshInterval, FWidgetActiveTimerDelegate::CreateSP(this, &SDsDiagnosticsPanel::Refresh));
+}
+
+void SDsDiagnosticsPanel::RegisterTabSpawner()
+{
+	FGlobalTabmanager::Get()->RegisterNomadTabSpawner(DsDiagnosticsPanel::TabName, FOnSpawnTab::CreateLambda([](const FSpawnTabArgs&)
+	                         {
+		                         return SNew(SDockTab)
+			                         .TabRole(NomadTab)
+			                         [
+				                         SNew(SDsDiagnosticsPanel)
+			                         ];
+	                         }))
+	                         .SetDisplayName(LOCTEXT("TabTitle", "DualSense Diagnostics"))
+	                         .SetMenuType(ETabSpawnerMenuType::Hidden);
+}
+
+void SDsDiagnosticsPanel::UnregisterTabSpawner()
+{
+	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(DsDiagnosticsPanel::TabName);
+}
+
+void SDsDiagnosticsPanel::OpenTab()
+{
+	FGlobalTabmanager::Get()->TryInvokeTab(FTabId{DsDiagnosticsPanel::TabName});
+}
+
+EActiveTimerReturnType SDsDiagnosticsPanel::Refresh(const double CurrentTime, const float DeltaTime)
+{
+	const auto Time{FPlatformTime::Seconds()};
+
+	for (auto i{0}; i < DsConstants::MaxDevicesCount; i++)
+	{
+		DeviceTexts[i]->SetText(MakeDeviceText(i, Time));
+	}
+
+	return EActiveTimerReturnType::Continue;
+}
+
+FText SDsDiagnosticsPanel::MakeDeviceText(const int32 ControllerId, const double Time)
+{
+	auto& PreviousSample{PreviousSamples[ControllerId]};
+
+	FDsLinkQualityStatistics LinkQuality;
+	FDsIoStatistics Io;
+
+	if (!DsStatistics::GetLinkQuality(ControllerId, LinkQuality) || !DsStatistics::GetIo(ControllerId, Io))
+	{
+		PreviousSample.bValid = false;
+		return FText::FromString(FString::Printf(TEXT("Controller %d: Not connected."), ControllerId));
+	}
+
+	FDsInputSnapshot Snapshot;
+	DsInputSnapshot::Read(ControllerId, Snapshot);
+
+	FCountersSample Sample{
+		.Time = Time,
+		.ReceivedReportsCount = LinkQuality.ReceivedReportsCount,
+		.OutputWritesCount = Io.OutputWritesCount,
+		.bValid = true
+	};
+
+	FMemory::Memcpy(Sample.ReportAgeHistogram, Io.ReportAgeHistogram);
+
+	// Rates and the report age distribution are measured since the previous refresh, so that they reflect the current state.
+
+	auto ReportRate{0.0};
+	auto OutputWriteRate{0.0};
+
+	uint64 ReportAgeHistogram[FDsIoStatistics::ReportAgeBucketsCount]{};
+	uint64 ReportAgeSamplesCount{0};
+
+	if (PreviousSample.bValid && Sample.Time > PreviousSample.Time)
+	{
+		const auto SampleTime{Sample.Time - PreviousSample.Time};
+
+		ReportRate = (Sample.ReceivedReportsCount - PreviousSample.ReceivedReportsCount) / SampleTime;
+		OutputWriteRate = (Sample.OutputWritesCount - PreviousSample.OutputWritesCount) / SampleTime;
+
+		for (auto i{0}; i < FDsIoStatistics::ReportAgeBucketsCount; i++)
+		{
+			ReportAgeHistogram[i] = Sample.ReportAgeHistogram[i] - PreviousSample.ReportAgeHistogram[i];
+			ReportAgeSamplesCount += ReportAgeHistogram[i];
+		}
+	}
+
+	PreviousSample = Sample;
+
+	TStringBuilder<1024> Text;
+
+	Text.Appendf(TEXT("Controller %d: %s, Battery: %d%%%s\n"), ControllerId, Io.bBluetooth ? TEXT("Bluetooth") : TEXT("USB"),
+	             Snapshot.BatteryLevel * 10, Snapshot.bCharging ? TEXT(" (Charging)") : TEXT(""));
+
+	Text.Appendf(TEXT("  Report Rate: %.1f Hz, Report Interval: %.3f ms, Jitter: %.3f ms, Dropped: %.2f%%\n"),
+	             ReportRate, LinkQuality.ReportIntervalMs, LinkQuality.JitterMs, LinkQuality.LossRate * 100.0f);
+
+	Text.Appendf(TEXT("  Output Writes: %.1f/s, Failed Reads: %llu, Failed Writes: %llu, Corrupted Reports: %llu\n"),
+	             OutputWriteRate, Io.FailedReadsCount, Io.FailedWritesCount, LinkQuality.CorruptedReportsCount);
+
+	Text.Append(TEXT("  Report Age at Dispatch:"));
+
+	for (auto i{0}; i < FDsIoStatistics::ReportAgeBucketsCount; i++)
+	{
+		const auto Percentage{ReportAgeSamplesCount > 0 ? ReportAgeHistogram[i] * 100.0 / ReportAgeSamplesCount : 0.0};
+
+		if (i < FDsIoStatistics::ReportAgeBucketsCount - 1)
+		{
+			Text.Appendf(TEXT(" <%.0f ms: %5.1f%%"), FDsIoStatistics::ReportAgeBucketLimitsMs[i], Percentage);
+		}
+		else
+		{
+			Text.Appendf(TEXT(" >=%.0f ms: %5.1f%%"), FDsIoStatistics::ReportAgeBucketLimitsMs[i - 1], Percentage);
+		}
+	}
+
+	return FText::FromString(FString{Text});
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "DsConstants.h"
+#include "DsStatistics.h"
+#include "Widgets/SCompoundWidget.h"
+
+class STextBlock;
+
+// Shows the report rate, the report age, the I/O health and the battery of every controller. Refreshed at a low rate
+// from the statistics counters, which are updated anyway, so keeping the panel open doesn't affect the measurements.
+class FABULOUSDUALSENSE_API SDsDiagnosticsPanel : public SCompoundWidget
+{
+private:
+	struct FCountersSample
+	{
+		double Time{0.0};
+
+		uint64 ReceivedReportsCount{0};
+
+		uint64 OutputWritesCount{0};
+
+		uint64 ReportAgeHistogram[FDsIoStatistics::ReportAgeBucketsCount]{};
+
+		uint8 bValid : 1 {false};
+	};
+
+	FCountersSample PreviousSamples[DsConstants::MaxDevicesCount];
+
+	TSharedPtr<STextBlock> DeviceTexts[DsConstants::MaxDevicesCount];
+
+public:
+	SLATE_BEGIN_ARGS(SDsDiagnosticsPanel) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& Arguments);
+
+	static void RegisterTabSpawner();
+
+	static void UnregisterTabSpawner();
+
+	static void OpenTab();
+
+private:
+	EActiveTimerReturnType Refresh(double CurrentTime, float DeltaTime);
+
+	FText MakeDeviceText(int32 ControllerId, double Time);
+};
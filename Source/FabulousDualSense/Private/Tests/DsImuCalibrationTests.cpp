@@ -0,0 +1,133 @@
+#include "DsImuCalibration.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace DsImuCalibrationTests
+{
+	// Calculates AxisCalibrationData::calibrate() in 64 bits. Returns false when mult_frac() overflows
+	// the 32-bit integers it uses, in which case its result is undefined and there is nothing to compare with.
+	bool Calibrate(const DS5W::AxisCalibrationData& Axis, const int32 RawValue, int32& CalibratedValue)
+	{
+		const int64 Value{RawValue - Axis.bias};
+
+		const auto QuotientPart{static_cast<int64>(Axis.sens_numer) / Axis.sens_denom * Value};
+		const auto Product{static_cast<int64>(Axis.sens_numer) % Axis.sens_denom * Value};
+		const auto Result{QuotientPart + Product / Axis.sens_denom};
+
+		for (const auto Intermediate : {QuotientPart, Product, Result})
+		{
+			if (Intermediate < TNumericLimits<int32>::Min() || Intermediate > TNumericLimits<int32>::Max())
+			{
+				return false;
+			}
+		}
+
+		CalibratedValue = static_cast<int32>(Result);
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDsImuCalibrationBitExactnessTest, "FabulousDualSense.ImuCalibration.BitExactness",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FDsImuCalibrationBitExactnessTest::RunTest(const FString& Parameters)
+{
+	static constexpr auto CalibrationsCount{64};
+
+	const FRandomStream RandomStream{0xD5};
+
+	TArray<DS5W::DeviceCalibrationData> CalibrationDatas;
+	CalibrationDatas.SetNumZeroed(CalibrationsCount);
+
+	for (auto& CalibrationData : CalibrationDatas)
+	{
+		// Values similar to those reported by real devices.
+
+		for (auto& Axis : CalibrationData.gyroscope)
+		{
+			Axis.bias = static_cast<short>(RandomStream.RandRange(-64, 64));
+			Axis.sens_numer = RandomStream.RandRange(1900, 2100) * DS_GYRO_RES_PER_DEG_S;
+			Axis.sens_denom = RandomStream.RandRange(30000, 36000);
+		}
+
+		for (auto& Axis : CalibrationData.accelerometer)
+		{
+			Axis.bias = static_cast<short>(RandomStream.RandRange(-256, 256));
+			Axis.sens_numer = 2 * DS_ACC_RES_PER_G;
+			Axis.sens_denom = RandomStream.RandRange(15000, 18000);
+		}
+	}
+
+	// Edge cases: negative denominators, extreme values, powers of two and overflowing products.
+
+	CalibrationDatas[0].gyroscope[0] = {TNumericLimits<int16>::Min(), TNumericLimits<int32>::Max(), -TNumericLimits<int32>::Max()};
+	CalibrationDatas[0].gyroscope[1] = {TNumericLimits<int16>::Max(), -1000000000, (1 << 30) + 12345};
+	CalibrationDatas[0].gyroscope[2] = {5, 100, -7};
+	CalibrationDatas[0].accelerometer[0] = {0, 65535, 2};
+	CalibrationDatas[0].accelerometer[1] = {0, -TNumericLimits<int32>::Max(), 65536};
+	CalibrationDatas[0].accelerometer[2] = {-1, 7, 1};
+
+	int64 CheckedValuesCount{0};
+	int64 MismatchesCount{0};
+
+	for (auto& CalibrationData : CalibrationDatas)
+	{
+		FDsImuCalibration ImuCalibration;
+		ImuCalibration.Compile(CalibrationData);
+
+		const DS5W::AxisCalibrationData* Axes[FDsImuCalibration::AxesCount]{
+			&CalibrationData.gyroscope[0], &CalibrationData.gyroscope[1], &CalibrationData.gyroscope[2],
+			&CalibrationData.accelerometer[0], &CalibrationData.accelerometer[1], &CalibrationData.accelerometer[2]
+		};
+
+		for (int32 RawValue{TNumericLimits<int16>::Min()}; RawValue <= TNumericLimits<int16>::Max(); RawValue++)
+		{
+			int16 RawValues[FDsImuCalibration::AxesCount];
+
+			for (auto& Value : RawValues)
+			{
+				Value = static_cast<int16>(RawValue);
+			}
+
+			int32 CalibratedValues[FDsImuCalibration::AxesCount];
+			int32 ScalarCalibratedValues[FDsImuCalibration::AxesCount];
+			float PhysicalValues[FDsImuCalibration::AxesCount];
+
+			ImuCalibration.Calibrate(RawValues, CalibratedValues, PhysicalValues);
+			ImuCalibration.CalibrateScalar(RawValues, ScalarCalibratedValues, PhysicalValues);
+
+			for (auto i{0}; i < FDsImuCalibration::AxesCount; i++)
+			{
+				int32 ExpectedValue;
+				if (!DsImuCalibrationTests::Calibrate(*Axes[i], RawValue, ExpectedValue))
+				{
+					continue;
+				}
+
+				CheckedValuesCount += 1;
+
+				if (CalibratedValues[i] != ExpectedValue || ScalarCalibratedValues[i] != ExpectedValue)
+				{
+					// Only the first mismatch is reported, so that a broken calibration doesn't flood the log.
+
+					if (MismatchesCount <= 0)
+					{
+						AddError(FString::Printf(TEXT("Axis %d, raw value %d: expected %d, got %d (SIMD) and %d (scalar)."),
+						                         i, RawValue, ExpectedValue, CalibratedValues[i], ScalarCalibratedValues[i]));
+					}
+
+					MismatchesCount += 1;
+				}
+			}
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("%lld values checked, %lld mismatches."), CheckedValuesCount, MismatchesCount));
+
+	return MismatchesCount <= 0;
+}
+
+#endif
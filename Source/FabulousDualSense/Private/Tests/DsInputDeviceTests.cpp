@@ -0,0 +1,20 @@
+#include "DsInputDevice.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDsInputDeviceAllocationsTest, "FabulousDualSense.InputDevice.SteadyStateAllocations",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FDsInputDeviceAllocationsTest::RunTest(const FString& Parameters)
+{
+	// The test uses its own input device without device discovery, so that connected controllers don't occupy its controller IDs.
+	// Its simulated device has its own input device ID and is never published, so it doesn't affect connected controllers either.
+
+	const auto InputDevice{MakeShared<FDsInputDevice>(MakeShared<FGenericApplicationMessageHandler>(), false)};
+
+	return TestTrue(TEXT("The input path doesn't allocate in steady state"), InputDevice->CheckAllocations(*GLog, 600));
+}
+
+#endif
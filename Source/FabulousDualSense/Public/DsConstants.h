@@ -9,7 +9,11 @@ namespace DsConstants
 	FABULOUSDUALSENSE_API extern const FString HardwareDeviceIdentifier;
 
 	inline constexpr auto MaxDevicesCount{4};
-	inline constexpr auto ButtonsCount{29};
+	inline constexpr auto MaxInputReportsPerFrame{64};
+
+	UE_DEPRECATED(5.5, "The buttons are now described by the key table of the plugin, this constant is no longer used.")
+	inline constexpr auto ButtonsCount{33};
+
 	inline constexpr auto StickDeadZone{30};
 	inline constexpr auto TriggerDeadZone{30};
 
@@ -17,6 +21,13 @@ namespace DsConstants
 	FABULOUSDUALSENSE_API extern const FKey LogoKey;
 	FABULOUSDUALSENSE_API extern const FKey MuteKey;
 
+	// DualSense Edge only.
+
+	FABULOUSDUALSENSE_API extern const FKey LeftFunctionKey;
+	FABULOUSDUALSENSE_API extern const FKey RightFunctionKey;
+	FABULOUSDUALSENSE_API extern const FKey LeftPaddleKey;
+	FABULOUSDUALSENSE_API extern const FKey RightPaddleKey;
+
 	FABULOUSDUALSENSE_API extern const FKey Touch1Key;
 	FABULOUSDUALSENSE_API extern const FKey Touch1AxisXKey;
 	FABULOUSDUALSENSE_API extern const FKey Touch1AxisYKey;
@@ -32,5 +43,27 @@ namespace DsConstants
 	FABULOUSDUALSENSE_API extern const FKey GyroscopeAxisYawKey;
 	FABULOUSDUALSENSE_API extern const FKey GyroscopeAxisYawPitchKey;
 
+	FABULOUSDUALSENSE_API extern const FKey AccelerometerAxisXKey;
+	FABULOUSDUALSENSE_API extern const FKey AccelerometerAxisYKey;
+	FABULOUSDUALSENSE_API extern const FKey AccelerometerAxisZKey;
+
+	FABULOUSDUALSENSE_API extern const FKey GravityAxisXKey;
+	FABULOUSDUALSENSE_API extern const FKey GravityAxisYKey;
+	FABULOUSDUALSENSE_API extern const FKey GravityAxisZKey;
+
+	FABULOUSDUALSENSE_API extern const FKey GyroAimAxisXKey;
+	FABULOUSDUALSENSE_API extern const FKey GyroAimAxisYKey;
+	FABULOUSDUALSENSE_API extern const FKey GyroAimAxisXYKey;
+
+	FABULOUSDUALSENSE_API extern const FKey ShakeKey;
+	FABULOUSDUALSENSE_API extern const FKey FlickLeftKey;
+	FABULOUSDUALSENSE_API extern const FKey FlickRightKey;
+	FABULOUSDUALSENSE_API extern const FKey FlickUpKey;
+	FABULOUSDUALSENSE_API extern const FKey FlickDownKey;
+	FABULOUSDUALSENSE_API extern const FKey FaceDownKey;
+	FABULOUSDUALSENSE_API extern const FKey UprightKey;
+
+	// Button keys that are read from the buttons map, excluding the DualSense Edge ones, mapped to their flags in it.
+	UE_DEPRECATED(5.5, "The buttons are now described by the key table of the plugin, this map is no longer used.")
 	FABULOUSDUALSENSE_API const TMap<FGamepadKeyNames::Type, uint32>& GetRegularButtons();
 }
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "GenericPlatform/IInputInterface.h"
+
+enum class EDsPlayerLedsBrightness : uint8
+{
+	Low,
+	Medium,
+	High
+};
+
+enum class EDsMicLedState : uint8
+{
+	Off,
+	On,
+	Pulse
+};
+
+struct FABULOUSDUALSENSE_API FDsPlayerLedsProperty : public FInputDeviceProperty
+{
+	// Bitmask of the five player LEDs below the touchpad, from left to right.
+	uint8 LedsMask{0};
+
+	EDsPlayerLedsBrightness Brightness{EDsPlayerLedsBrightness::High};
+
+	uint8 bFadeIn : 1 {false};
+
+public:
+	explicit FDsPlayerLedsProperty(const uint8 LedsMask = 0, const EDsPlayerLedsBrightness Brightness = EDsPlayerLedsBrightness::High,
+	                               const bool bFadeIn = false)
+		: FInputDeviceProperty{PropertyName()}, LedsMask{LedsMask}, Brightness{Brightness}, bFadeIn{bFadeIn} {}
+
+	static FName PropertyName();
+};
+
+struct FABULOUSDUALSENSE_API FDsMicLedProperty : public FInputDeviceProperty
+{
+	EDsMicLedState State{EDsMicLedState::Off};
+
+public:
+	explicit FDsMicLedProperty(const EDsMicLedState State = EDsMicLedState::Off)
+		: FInputDeviceProperty{PropertyName()}, State{State} {}
+
+	static FName PropertyName();
+};
+
+namespace DsDeviceProperties
+{
+	// Applies all properties to the device at once. Any resulting changes are merged
+	// and sent to the device as a single output state update during the next frame.
+	FABULOUSDUALSENSE_API void SetDeviceProperties(int32 ControllerId, TConstArrayView<const FInputDeviceProperty*> Properties);
+}
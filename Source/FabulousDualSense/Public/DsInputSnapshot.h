@@ -0,0 +1,66 @@
+#pragma once
+
+struct FABULOUSDUALSENSE_API FDsTouchSnapshot
+{
+	// In touchpad pixels, from 0 to 1919 horizontally and from 0 to 1079 vertically.
+	FIntPoint Position{ForceInit};
+
+	uint8 Id{0};
+
+	uint8 bDown : 1 {false};
+};
+
+// Decoded state of a controller as of its latest input report.
+struct FABULOUSDUALSENSE_API FDsInputSnapshot
+{
+	// Incremented with every published input report, so it can be used to detect new reports.
+	uint64 SequenceNumber{0};
+
+	// FPlatformTime::Seconds() at the time the report was processed.
+	double Time{0.0};
+
+	// The controller's own timestamp of the report, measured in 0.33 microseconds.
+	uint32 SensorTimestamp{0};
+
+	// From -1 to 1.
+	FVector2f LeftStick{ForceInit};
+	FVector2f RightStick{ForceInit};
+
+	// From 0 to 1.
+	float LeftTrigger{0.0f};
+	float RightTrigger{0.0f};
+
+	// Combination of DS5W_ISTATE_BTN_* flags.
+	uint32 Buttons{0};
+
+	// Degrees per second.
+	FVector3f Gyroscope{ForceInit};
+
+	// Gyroscope integrated over the sensor time, in degrees wrapped to the [-180, 180] range. The
+	// difference between two snapshots is the rotation of the controller between these snapshots.
+	FVector3f IntegratedGyroscope{ForceInit};
+
+	// Multiples of the standard gravity.
+	FVector3f Accelerometer{ForceInit};
+	FVector3f Gravity{ForceInit};
+
+	FDsTouchSnapshot Touches[2];
+
+	// From 0 to 10.
+	uint8 BatteryLevel{0};
+
+	uint8 bConnected : 1 {false};
+
+	uint8 bCharging : 1 {false};
+
+	uint8 bFullyCharged : 1 {false};
+
+	uint8 bHeadphonesConnected : 1 {false};
+};
+
+namespace DsInputSnapshot
+{
+	// Can be called from any thread. The snapshot is published with a sequence lock, so the reader never
+	// blocks the input thread and never sees a partially updated snapshot, it retries the copy instead.
+	FABULOUSDUALSENSE_API bool Read(int32 ControllerId, FDsInputSnapshot& Snapshot);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Templates/FunctionFwd.h"
+
+// Raw input report of a controller, as received from the device.
+struct FABULOUSDUALSENSE_API FDsRawReport
+{
+	// Incremented with every published report of any controller.
+	uint64 SequenceNumber{0};
+
+	// FPlatformTime::Seconds() of the frame that processed the report, so it's shared by all reports read during that frame
+	// and is simulated during replays. Use the sensor timestamp in the report, measured in 0.33 microseconds, to tell when
+	// the reports were actually sampled.
+	double Time{0.0};
+
+	int32 ControllerId{INDEX_NONE};
+
+	// The whole report, including the report ID and, over Bluetooth, the CRC. Points directly
+	// into the ring buffer of raw reports, so it's only valid until the visitor returns.
+	TConstArrayView<uint8> Data;
+};
+
+// Reads the raw input reports of all controllers from a shared ring buffer, in place and at its own pace. If the reader
+// falls behind by more than the ring buffer size, the oldest reports are overwritten and counted as missed instead of
+// stalling the input processing. Bluetooth reports with invalid CRC are not published. Must only be used on the game thread.
+class FABULOUSDUALSENSE_API FDsRawReportReader
+{
+private:
+	uint64 NextSequenceNumber{0};
+
+	uint64 MissedReportsCount{0};
+
+public:
+	// Only reports published after the reader is created are read.
+	FDsRawReportReader();
+
+	~FDsRawReportReader();
+
+	// Calls the visitor for every report published since the previous call, from oldest to newest.
+	// Returns the number of reports that were overwritten before this reader could read them.
+	uint64 Read(TFunctionRef<void(const FDsRawReport& Report)> Visitor);
+
+	uint64 GetMissedReportsCount() const;
+
+	FDsRawReportReader(const FDsRawReportReader&) = delete;
+
+	FDsRawReportReader& operator=(const FDsRawReportReader&) = delete;
+};
@@ -1,8 +1,24 @@
 #pragma once
 
+#include "InputCoreTypes.h"
 #include "Engine/DeveloperSettings.h"
 #include "DsSettings.generated.h"
 
+// How the rotation of the controller is turned into the camera yaw.
+UENUM(BlueprintType)
+enum class EDsGyroAimSpace : uint8
+{
+	// The controller's own yaw axis, which only works well when the controller is held flat.
+	Local,
+
+	// The rotation around the gravity vector, mixed with the controller's own yaw and roll axes so that turning
+	// works the same way regardless of how the controller is held. Suits most players.
+	Player,
+
+	// The rotation around the gravity vector only, which matches the turns of the player's body exactly.
+	World
+};
+
 UCLASS(Config = "Engine", DefaultConfig)
 class FABULOUSDUALSENSE_API UDsSettings : public UDeveloperSettings
 {
@@ -12,6 +28,242 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense", Config)
 	uint8 bEmitMouseEventsFromTouchpad : 1 {false};
 
+	// If enabled, stick and trigger values are sent to the game only when they change by more than the
+	// threshold, instead of on every frame while they are outside the dead zone. Values that stay the same
+	// are still resent at a low rate, in case the game missed them. Values entering the dead zone are always sent.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Analog", Config)
+	uint8 bSendAnalogOnChangeOnly : 1 {false};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Analog", Config,
+		Meta = (EditCondition = "bSendAnalogOnChangeOnly", ClampMin = 0, ClampMax = 1))
+	float AnalogChangeThreshold{0.002f};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Analog", Config,
+		Meta = (EditCondition = "bSendAnalogOnChangeOnly", ClampMin = 0, ForceUnits = "s"))
+	float AnalogKeepAliveInterval{0.25f};
+
+	// If enabled, the gyroscope is smoothed with a One Euro filter on every input report, which removes
+	// sensor noise when the controller is held still while adding almost no lag during fast motion.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Smoothing", Config)
+	uint8 bEnableGyroSmoothing : 1 {false};
+
+	// The cutoff frequency at rest. Lower values remove more jitter, but add more lag during slow motion.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Smoothing", Config,
+		Meta = (EditCondition = "bEnableGyroSmoothing", ClampMin = 0.01, ForceUnits = "Hz"))
+	float GyroSmoothingMinCutoff{1.0f};
+
+	// How fast the cutoff frequency rises with the angular velocity, in hertz per degree per second.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Smoothing", Config,
+		Meta = (EditCondition = "bEnableGyroSmoothing", ClampMin = 0))
+	float GyroSmoothingBeta{0.05f};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Smoothing", Config)
+	uint8 bEnableStickSmoothing : 1 {false};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Smoothing", Config,
+		Meta = (EditCondition = "bEnableStickSmoothing", ClampMin = 0.01, ForceUnits = "Hz"))
+	float StickSmoothingMinCutoff{2.0f};
+
+	// How fast the cutoff frequency rises with the stick speed, in hertz per full stick deflection per second.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Smoothing", Config,
+		Meta = (EditCondition = "bEnableStickSmoothing", ClampMin = 0))
+	float StickSmoothingBeta{1.0f};
+
+	// If enabled, stick and gyroscope values are extrapolated from the time the latest input report
+	// was sampled by the controller to the time they are sent to the game, which hides part of the latency.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Input Prediction", Config)
+	uint8 bEnableInputPrediction : 1 {false};
+
+	// The delay between a report being sampled by the controller and being available for reading when the
+	// connection is idle. It can't be measured from the report timestamps and depends on the connection type.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Input Prediction", Config,
+		Meta = (EditCondition = "bEnableInputPrediction", ClampMin = 0, ForceUnits = "s"))
+	float InputPredictionTransportLatency{0.004f};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Input Prediction", Config,
+		Meta = (EditCondition = "bEnableInputPrediction", ClampMin = 0, ForceUnits = "s"))
+	float MaxInputPredictionTime{0.012f};
+
+	// Axes whose velocity changed more than this allows between the latest reports are not extrapolated.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Input Prediction", Config,
+		Meta = (EditCondition = "bEnableInputPrediction", ClampMin = 0, ClampMax = 1))
+	float MinInputPredictionConfidence{0.5f};
+
+	// If enabled, controllers that have been untouched for some time are polled at a low rate until any input is detected again.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Idle Polling", Config)
+	uint8 bEnableIdlePolling : 1 {false};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Idle Polling", Config,
+		Meta = (EditCondition = "bEnableIdlePolling", ClampMin = 0, ForceUnits = "s"))
+	float IdleTimeout{30.0f};
+
+	// Also determines the maximum delay before an idle controller responds to input again.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Idle Polling", Config,
+		Meta = (EditCondition = "bEnableIdlePolling", ClampMin = 0, ForceUnits = "s"))
+	float IdlePollingInterval{0.1f};
+
+	// The number of fast reconnection attempts made after a controller stops responding, before it is disconnected and
+	// has to be found by the regular device enumeration again. Zero disables the fast reconnection.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Reconnection", Config, Meta = (ClampMin = 0))
+	int32 ReconnectAttemptsCount{8};
+
+	// The delay before the first reconnection attempt, doubled after each failed attempt.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Reconnection", Config,
+		Meta = (EditCondition = "ReconnectAttemptsCount > 0", ClampMin = 0, ForceUnits = "s"))
+	float ReconnectInitialDelay{0.005f};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Reconnection", Config,
+		Meta = (EditCondition = "ReconnectAttemptsCount > 0", ClampMin = 0, ForceUnits = "s"))
+	float ReconnectMaxDelay{0.5f};
+
+	// How long the module shutdown waits for the controllers to be released, before abandoning the ones that are stuck.
+	// Controllers are released in parallel, so this doesn't depend on the number of connected controllers.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Shutdown", Config, Meta = (ClampMin = 0, ForceUnits = "s"))
+	float ShutdownTimeBudget{0.1f};
+
+	// Time constant of the low-pass filter that extracts the gravity vector from the accelerometer.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Motion", Config, Meta = (ClampMin = 0, ForceUnits = "s"))
+	float GravityFilterTimeConstant{0.2f};
+
+	// The minimum change of the accelerometer and gravity values required to send them to the game again.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Motion", Config, Meta = (ClampMin = 0))
+	float AccelerationChangeThreshold{0.01f};
+
+	// If enabled, the gyroscope bias is estimated whenever the controller is lying still and subtracted from the gyroscope,
+	// which stops the camera from creeping. Estimates are cached per controller, so they are ready on the next connection.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyroscope Bias", Config)
+	uint8 bEnableGyroBiasCalibration : 1 {false};
+
+	// How long the controller must stay still before the bias is estimated.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyroscope Bias", Config,
+		Meta = (EditCondition = "bEnableGyroBiasCalibration", ClampMin = 0.1, ForceUnits = "s"))
+	float GyroBiasStationaryWindow{1.0f};
+
+	// The maximum standard deviation of the gyroscope within the window for the controller to count as still.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyroscope Bias", Config,
+		Meta = (EditCondition = "bEnableGyroBiasCalibration", ClampMin = 0, ForceUnits = "deg/s"))
+	float GyroBiasMaxGyroscopeDeviation{0.5f};
+
+	// The maximum standard deviation of the accelerometer within the window for the controller to count as still.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyroscope Bias", Config,
+		Meta = (EditCondition = "bEnableGyroBiasCalibration", ClampMin = 0))
+	float GyroBiasMaxAccelerometerDeviation{0.01f};
+
+	// Steady rotations faster than this are not mistaken for a bias, for example when the controller lies on a turntable.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyroscope Bias", Config,
+		Meta = (EditCondition = "bEnableGyroBiasCalibration", ClampMin = 0, ForceUnits = "deg/s"))
+	float GyroBiasMaxOffset{5.0f};
+
+	// Time constant of the low-pass filter that blends new estimates into the current bias.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyroscope Bias", Config,
+		Meta = (EditCondition = "bEnableGyroBiasCalibration", ClampMin = 0, ForceUnits = "s"))
+	float GyroBiasTimeConstant{2.0f};
+
+	// The minimum linear acceleration, excluding gravity, that counts as a shake movement.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Motion Events", Config, Meta = (ClampMin = 0))
+	float ShakeAccelerationThreshold{1.0f};
+
+	// The number of direction changes that must happen within the shake duration.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Motion Events", Config, Meta = (ClampMin = 1, ClampMax = 16))
+	int32 ShakeReversalsCount{4};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Motion Events", Config, Meta = (ClampMin = 0, ForceUnits = "s"))
+	float ShakeDuration{0.6f};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Motion Events", Config,
+		Meta = (ClampMin = 0, ForceUnits = "deg/s"))
+	float FlickAngularVelocityThreshold{360.0f};
+
+	// Rotations that take longer than this are not considered flicks.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Motion Events", Config, Meta = (ClampMin = 0, ForceUnits = "s"))
+	float FlickMaxDuration{0.2f};
+
+	// The maximum deviation of the controller from the face down or upright orientation.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Motion Events", Config,
+		Meta = (ClampMin = 0, ClampMax = 80, ForceUnits = "deg"))
+	float OrientationAngleThreshold{25.0f};
+
+	// How long the controller must stay in the face down or upright orientation before it is reported.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Motion Events", Config, Meta = (ClampMin = 0, ForceUnits = "s"))
+	float OrientationHoldTime{0.3f};
+
+	// If enabled, the gyroscope is turned into a camera rotation on every input report and sent once per frame as the
+	// DualSense Gyro Aim key, whose X and Y axes are the yaw to the right and the pitch up in degrees since the previous frame.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyro Aim", Config)
+	uint8 bEnableGyroAim : 1 {false};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyro Aim", Config, Meta = (EditCondition = "bEnableGyroAim"))
+	EDsGyroAimSpace GyroAimSpace{EDsGyroAimSpace::Player};
+
+	// Camera degrees per controller degree when the controller rotates at or below the slow threshold.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyro Aim", Config,
+		Meta = (EditCondition = "bEnableGyroAim", ClampMin = 0))
+	float GyroAimSlowSensitivity{1.0f};
+
+	// Camera degrees per controller degree when the controller rotates at or above the fast threshold.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyro Aim", Config,
+		Meta = (EditCondition = "bEnableGyroAim", ClampMin = 0))
+	float GyroAimFastSensitivity{2.0f};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyro Aim", Config,
+		Meta = (EditCondition = "bEnableGyroAim", ClampMin = 0, ForceUnits = "deg/s"))
+	float GyroAimSlowThreshold{0.0f};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyro Aim", Config,
+		Meta = (EditCondition = "bEnableGyroAim", ClampMin = 0, ForceUnits = "deg/s"))
+	float GyroAimFastThreshold{75.0f};
+
+	// The shape of the acceleration between the thresholds. One is linear, higher values keep the sensitivity low for longer.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyro Aim", Config,
+		Meta = (EditCondition = "bEnableGyroAim", ClampMin = 0.1, ClampMax = 10))
+	float GyroAimAccelerationExponent{1.0f};
+
+	// Rotations slower than this are scaled down proportionally to their speed, which hides the sensor
+	// noise and the shaking of the hands without a hard dead zone. Zero disables the tightening.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyro Aim", Config,
+		Meta = (EditCondition = "bEnableGyroAim", ClampMin = 0, ForceUnits = "deg/s"))
+	float GyroAimTighteningThreshold{3.0f};
+
+	// While this button is held, the gyroscope doesn't rotate the camera, so that the controller can be
+	// re-centered, the same way a mouse is lifted off the desk. Only DualSense buttons are supported.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyro Aim", Config, Meta = (EditCondition = "bEnableGyroAim"))
+	FKey GyroAimRatchetKey;
+
+	// If enabled, the right stick is added to the gyro aim as a flick stick: tilting the stick turns the camera
+	// towards the direction of the stick, and rotating the tilted stick turns the camera by the same angle.
+	// The game should ignore the right stick for the camera in that case.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyro Aim", Config, Meta = (EditCondition = "bEnableGyroAim"))
+	uint8 bEnableFlickStick : 1 {false};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyro Aim", Config,
+		Meta = (EditCondition = "bEnableGyroAim && bEnableFlickStick", ClampMin = 0.1, ClampMax = 1))
+	float FlickStickThreshold{0.9f};
+
+	// How long it takes the camera to turn towards the direction of the stick.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyro Aim", Config,
+		Meta = (EditCondition = "bEnableGyroAim && bEnableFlickStick", ClampMin = 0, ForceUnits = "s"))
+	float FlickStickTime{0.1f};
+
+	// If enabled, the rotation of the controller that happened after the game thread has processed input is
+	// applied to the camera on the render thread right before the view is rendered, similar to VR head pose
+	// late latching. The correction only affects rendering, the game still receives the regular gyroscope input.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyroscope Late Latching", Config)
+	uint8 bEnableGyroLateLatching : 1 {false};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyroscope Late Latching", Config,
+		Meta = (EditCondition = "bEnableGyroLateLatching", ClampMin = 0, ClampMax = 3))
+	int32 GyroLateLatchingControllerId{0};
+
+	// Camera yaw in degrees per degree of the controller yaw. Should match the game's own gyroscope sensitivity.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyroscope Late Latching", Config,
+		Meta = (EditCondition = "bEnableGyroLateLatching"))
+	float GyroLateLatchingYawScale{1.0f};
+
+	// Camera pitch in degrees per degree of the controller pitch. Should match the game's own gyroscope sensitivity.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "DualSense|Gyroscope Late Latching", Config,
+		Meta = (EditCondition = "bEnableGyroLateLatching"))
+	float GyroLateLatchingPitchScale{1.0f};
+
 public:
 	UDsSettings();
 
@@ -0,0 +1,74 @@
+#pragma once
+
+struct FABULOUSDUALSENSE_API FDsLinkQualityStatistics
+{
+	uint64 ReceivedReportsCount{0};
+
+	// Reports that never arrived, detected by gaps in the report sequence number.
+	uint64 MissedReportsCount{0};
+
+	// Reports dropped by the host, because the OS input buffer overflowed while the game was hitching. Not counted as missed.
+	uint64 OverflowedReportsCount{0};
+
+	uint64 DuplicatedReportsCount{0};
+
+	// Bluetooth reports with an invalid CRC32 that were dropped.
+	uint64 CorruptedReportsCount{0};
+
+	// Gaps in the sensor timestamp that are not explained by missed reports.
+	uint64 TimestampGapsCount{0};
+
+	// The following values are calculated over the last few hundred reports.
+
+	float LossRate{0.0f};
+
+	float ReportIntervalMs{0.0f};
+
+	// Root mean square deviation of report intervals from the average report interval.
+	float JitterMs{0.0f};
+};
+
+struct FABULOUSDUALSENSE_API FDsPollingStatistics
+{
+	uint8 bIdle : 1 {false};
+
+	double ActiveTime{0.0};
+
+	double IdleTime{0.0};
+
+	uint64 PollsCount{0};
+
+	uint64 SkippedPollsCount{0};
+
+	// Estimated from the number of skipped polls and the average cost of a poll.
+	double SavedCpuTime{0.0};
+};
+
+struct FABULOUSDUALSENSE_API FDsIoStatistics
+{
+	static constexpr auto ReportAgeBucketsCount{6};
+
+	// Upper limits of all report age buckets except the last one, which has no upper limit.
+	static constexpr float ReportAgeBucketLimitsMs[ReportAgeBucketsCount - 1]{1.0f, 2.0f, 4.0f, 8.0f, 16.0f};
+
+	uint8 bBluetooth : 1 {false};
+
+	uint64 OutputWritesCount{0};
+
+	uint64 FailedReadsCount{0};
+
+	uint64 FailedWritesCount{0};
+
+	// Number of frames by the age of the latest input report at the time the input was sent to the game, measured
+	// relative to the reports that were read as soon as they arrived, so it doesn't include the minimal transport latency.
+	uint64 ReportAgeHistogram[ReportAgeBucketsCount]{};
+};
+
+namespace DsStatistics
+{
+	FABULOUSDUALSENSE_API bool GetLinkQuality(int32 ControllerId, FDsLinkQualityStatistics& Statistics);
+
+	FABULOUSDUALSENSE_API bool GetPolling(int32 ControllerId, FDsPollingStatistics& Statistics);
+
+	FABULOUSDUALSENSE_API bool GetIo(int32 ControllerId, FDsIoStatistics& Statistics);
+}